@@ -1,9 +1,94 @@
 #pragma once
 
+#include <KaneLib/Algorithms/MemoryOps.h>
+
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
 
 namespace kane {
 
+// True if two Ts are equal exactly when their bytes are, so ranges of them can be compared as
+// memory: integers, enums and pointers.  Specialise it for types made of those with no padding.
+// Not floating-point numbers, since -0 == +0 and NaN != NaN.
+template<typename T>
+struct is_bitwise_comparable : public std::bool_constant<std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value> { };
+
+namespace detail {
+	// Pointers to the same bitwise comparable type (give or take const), which the comparisons
+	// below compare as memory
+	template<typename T, typename U>
+	constexpr bool is_bitwise_comparable_pair = std::is_same<std::remove_cv_t<T>, std::remove_cv_t<U>>::value && is_bitwise_comparable<std::remove_cv_t<T>>::value;
+
+	template<typename T, typename U>
+	using enable_if_bitwise_comparable_t = std::enable_if_t<is_bitwise_comparable_pair<T, U>>;
+
+	// Single bytes that order the way memcmp() does, unsigned
+	template<typename T>
+	constexpr bool is_memcmp_ordered = std::is_same<T, unsigned char>::value || std::is_same<T, bool>::value || std::is_same<T, std::byte>::value ||
+		(std::is_same<T, char>::value && std::is_unsigned<char>::value);
+}
+
+// Index of the first position where [first1, first1 + count) and [first2, first2 + count) differ,
+// or count if they don't.  Bitwise comparable elements are compared with mismatch_bytes(), a
+// vector register at a time.
+template<typename T, typename U>
+inline std::size_t mismatch_index(const T* const first1, const U* const first2, const std::size_t count) {
+	if constexpr(detail::is_bitwise_comparable_pair<T, U>) {
+		return kane::mismatch_bytes(first1, first2, count * sizeof(T)) / sizeof(T);
+	} else {
+		std::size_t i = 0;
+		while(i != count && first1[i] == first2[i]) { ++i; }
+		return i;
+	}
+}
+
+// Result of kane::compare().  order is negative, zero or positive as the first range is
+// lexicographically less than, equal to or greater than the second.  index is where they first
+// differ: the first unequal element, or the length of the shorter range if it's a prefix of the
+// other (which makes it less), or their common length if they're equal.
+struct compare_result {
+	std::size_t index;
+	int order;
+};
+
+// Three-way lexicographical comparison of [first1, first1 + count1) and [first2, first2 + count2)
+template<typename T, typename U>
+inline compare_result compare(const T* const first1, const std::size_t count1, const U* const first2, const std::size_t count2) {
+	const std::size_t common = std::min(count1, count2);
+	const std::size_t i = kane::mismatch_index(first1, first2, common);
+	if(i != common) { return { i, (first1[i] < first2[i]) ? -1 : 1 }; }
+	return { common, (count1 < count2) ? -1 : (count2 < count1) ? 1 : 0 };
+}
+
+// As above, for contiguous containers (anything with data() and size())
+template<typename Container1, typename Container2>
+inline compare_result compare(const Container1& a, const Container2& b) {
+	return kane::compare(a.data(), a.size(), b.data(), b.size());
+}
+
+// Equality for equal-sized ranges
+template<typename InputIterator1, typename InputIterator2>
+inline bool unchecked_equal(InputIterator1 first1, const InputIterator1 last1, InputIterator2 first2) {
+	while(first1 != last1) {
+		if(!(*first1 == *first2)) { return false; }
+		++first1;
+		++first2;
+	}
+	return true;
+}
+
+// Equality for equal-sized ranges of bitwise comparable elements
+template<typename T, typename U, typename = detail::enable_if_bitwise_comparable_t<T, U>>
+inline bool unchecked_equal(T* const first1, T* const last1, U* const first2) {
+	const std::size_t count = std::size_t(last1 - first1);
+	return count == 0 || std::memcmp(first1, first2, count * sizeof(T)) == 0;
+}
+
 // Lexicographical compare for equal-sized ranges
 template<typename InputIterator1, typename InputIterator2>
 inline bool unchecked_lexicographical_compare(InputIterator1 first1, const InputIterator1 last1, InputIterator2 first2) {
@@ -34,10 +119,548 @@ inline bool unchecked_lexicographical_compare(InputIterator1 first1, const Input
 	return false;
 }
 
+// Lexicographical compare for equal-sized ranges of bitwise comparable elements: unsigned bytes
+// with memcmp(), anything else by comparing the first elements that differ
+template<typename T, typename U, typename = detail::enable_if_bitwise_comparable_t<T, U>>
+inline bool unchecked_lexicographical_compare(T* const first1, T* const last1, U* const first2) {
+	const std::size_t count = std::size_t(last1 - first1);
+	if constexpr(detail::is_memcmp_ordered<std::remove_cv_t<T>>) {
+		return count != 0 && std::memcmp(first1, first2, count) < 0;
+	} else {
+		const std::size_t i = kane::mismatch_index(first1, first2, count);
+		return i != count && first1[i] < first2[i];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Numeric reductions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Sums, dot products and the like over contiguous ranges, a vector register at a time.
+//
+// Adding floating-point numbers in a different order gives a (slightly) different answer, so the
+// floating-point versions take a float_order:
+//  - fast adds in as many independent lanes as keep the widest registers busy, so the result
+//    depends on which instruction sets the build targets.
+//  - deterministic always adds in eight lanes (element i goes to lane i % 8), combined in a fixed
+//    order at the end, so every build on every machine gets exactly the same answer, as long as
+//    the compiler doesn't fuse multiplies and adds on its own.  MSVC's default /fp:precise
+//    doesn't; GCC does when targeting FMA, unless given -ffp-contract=off.  It's still
+//    vectorised, and not much slower than fast.
+// Neither matches a plain left-to-right loop exactly, but both are usually closer to the true
+// answer, since each lane only sees a fraction of the elements.
+//
+// Integer versions are exact, and return 64-bit totals.
+enum class float_order { fast, deterministic };
+
+// Lowest and highest elements of a range, from kane::min_max()
+template<typename T>
+struct min_max_result {
+	T min;
+	T max;
+};
+
+namespace detail {
+
+// 64-bit for integers, or the type itself for floating-point numbers
+template<typename T>
+using sum_t = std::conditional_t<std::is_floating_point<T>::value, T, std::conditional_t<std::is_signed<T>::value, std::int64_t, std::uint64_t>>;
+
+template<typename T, typename U>
+using enable_if_arithmetic_pair_t = std::enable_if_t<std::is_same<std::remove_cv_t<T>, std::remove_cv_t<U>>::value && std::is_arithmetic<std::remove_cv_t<T>>::value>;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// simd_float
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Bytes-wide vector register of floats or doubles, and the arithmetic the reductions need.  The
+// sizeof(T) versions are plain scalars, for when there's nothing wider.
+template<typename T, std::size_t Bytes>
+struct simd_float;
+
+template<typename T>
+struct scalar_float {
+	typedef T type;
+	static constexpr std::size_t lanes = 1;
+	static KFINLINE type load(const T* const p) { return *p; }
+	static KFINLINE void store(T* const p, const type v) { *p = v; }
+	static KFINLINE type add(const type a, const type b) { return a + b; }
+	static KFINLINE type sub(const type a, const type b) { return a - b; }
+	static KFINLINE type mul(const type a, const type b) { return a * b; }
+	static KFINLINE type abs(const type a) { return std::abs(a); }
+	// Same answers as MINPS/MAXPS, NaNs included
+	static KFINLINE type min(const type a, const type b) { return (a < b) ? a : b; }
+	static KFINLINE type max(const type a, const type b) { return (a > b) ? a : b; }
+};
+template<> struct simd_float<float, sizeof(float)> : public scalar_float<float> { };
+template<> struct simd_float<double, sizeof(double)> : public scalar_float<double> { };
+
+#if defined(KANELIB_SSE2)
+template<>
+struct simd_float<float, 16> {
+	typedef __m128 type;
+	static constexpr std::size_t lanes = 4;
+	static KFINLINE type load(const float* const p) { return _mm_loadu_ps(p); }
+	static KFINLINE void store(float* const p, const type v) { _mm_storeu_ps(p, v); }
+	static KFINLINE type add(const type a, const type b) { return _mm_add_ps(a, b); }
+	static KFINLINE type sub(const type a, const type b) { return _mm_sub_ps(a, b); }
+	static KFINLINE type mul(const type a, const type b) { return _mm_mul_ps(a, b); }
+	static KFINLINE type abs(const type a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static KFINLINE type min(const type a, const type b) { return _mm_min_ps(a, b); }
+	static KFINLINE type max(const type a, const type b) { return _mm_max_ps(a, b); }
+};
+template<>
+struct simd_float<double, 16> {
+	typedef __m128d type;
+	static constexpr std::size_t lanes = 2;
+	static KFINLINE type load(const double* const p) { return _mm_loadu_pd(p); }
+	static KFINLINE void store(double* const p, const type v) { _mm_storeu_pd(p, v); }
+	static KFINLINE type add(const type a, const type b) { return _mm_add_pd(a, b); }
+	static KFINLINE type sub(const type a, const type b) { return _mm_sub_pd(a, b); }
+	static KFINLINE type mul(const type a, const type b) { return _mm_mul_pd(a, b); }
+	static KFINLINE type abs(const type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+	static KFINLINE type min(const type a, const type b) { return _mm_min_pd(a, b); }
+	static KFINLINE type max(const type a, const type b) { return _mm_max_pd(a, b); }
+};
+#endif
+
+#if defined(KANELIB_AVX2)
+template<>
+struct simd_float<float, 32> {
+	typedef __m256 type;
+	static constexpr std::size_t lanes = 8;
+	static KFINLINE type load(const float* const p) { return _mm256_loadu_ps(p); }
+	static KFINLINE void store(float* const p, const type v) { _mm256_storeu_ps(p, v); }
+	static KFINLINE type add(const type a, const type b) { return _mm256_add_ps(a, b); }
+	static KFINLINE type sub(const type a, const type b) { return _mm256_sub_ps(a, b); }
+	static KFINLINE type mul(const type a, const type b) { return _mm256_mul_ps(a, b); }
+	static KFINLINE type abs(const type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	static KFINLINE type min(const type a, const type b) { return _mm256_min_ps(a, b); }
+	static KFINLINE type max(const type a, const type b) { return _mm256_max_ps(a, b); }
+};
+template<>
+struct simd_float<double, 32> {
+	typedef __m256d type;
+	static constexpr std::size_t lanes = 4;
+	static KFINLINE type load(const double* const p) { return _mm256_loadu_pd(p); }
+	static KFINLINE void store(double* const p, const type v) { _mm256_storeu_pd(p, v); }
+	static KFINLINE type add(const type a, const type b) { return _mm256_add_pd(a, b); }
+	static KFINLINE type sub(const type a, const type b) { return _mm256_sub_pd(a, b); }
+	static KFINLINE type mul(const type a, const type b) { return _mm256_mul_pd(a, b); }
+	static KFINLINE type abs(const type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+	static KFINLINE type min(const type a, const type b) { return _mm256_min_pd(a, b); }
+	static KFINLINE type max(const type a, const type b) { return _mm256_max_pd(a, b); }
+};
+#endif
+
+#if defined(KANELIB_AVX512)
+template<>
+struct simd_float<float, 64> {
+	typedef __m512 type;
+	static constexpr std::size_t lanes = 16;
+	static KFINLINE type load(const float* const p) { return _mm512_loadu_ps(p); }
+	static KFINLINE void store(float* const p, const type v) { _mm512_storeu_ps(p, v); }
+	static KFINLINE type add(const type a, const type b) { return _mm512_add_ps(a, b); }
+	static KFINLINE type sub(const type a, const type b) { return _mm512_sub_ps(a, b); }
+	static KFINLINE type mul(const type a, const type b) { return _mm512_mul_ps(a, b); }
+	static KFINLINE type abs(const type a) { return _mm512_abs_ps(a); }
+	static KFINLINE type min(const type a, const type b) { return _mm512_min_ps(a, b); }
+	static KFINLINE type max(const type a, const type b) { return _mm512_max_ps(a, b); }
+};
+template<>
+struct simd_float<double, 64> {
+	typedef __m512d type;
+	static constexpr std::size_t lanes = 8;
+	static KFINLINE type load(const double* const p) { return _mm512_loadu_pd(p); }
+	static KFINLINE void store(double* const p, const type v) { _mm512_storeu_pd(p, v); }
+	static KFINLINE type add(const type a, const type b) { return _mm512_add_pd(a, b); }
+	static KFINLINE type sub(const type a, const type b) { return _mm512_sub_pd(a, b); }
+	static KFINLINE type mul(const type a, const type b) { return _mm512_mul_pd(a, b); }
+	static KFINLINE type abs(const type a) { return _mm512_abs_pd(a); }
+	static KFINLINE type min(const type a, const type b) { return _mm512_min_pd(a, b); }
+	static KFINLINE type max(const type a, const type b) { return _mm512_max_pd(a, b); }
+};
+#endif
+
+// Widest register available, in bytes
+constexpr std::size_t simd_float_max_bytes =
+#if defined(KANELIB_AVX512)
+	64;
+#elif defined(KANELIB_AVX2)
+	32;
+#elif defined(KANELIB_SSE2)
+	16;
+#else
+	0;
+#endif
+
+// Widest register for T no wider than lanes elements
+template<typename T>
+constexpr std::size_t simd_float_bytes(const std::size_t lanes) {
+	return std::max(std::min(simd_float_max_bytes, lanes * sizeof(T)), sizeof(T));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// float_pack
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Lanes floats or doubles, in as few registers as will hold them.  Lane i always means element
+// i of the pack, whatever the registers, which is what makes float_order::deterministic work.
+template<typename T, std::size_t Lanes>
+struct float_pack {
+	typedef simd_float<T, simd_float_bytes<T>(Lanes)> reg;
+	static constexpr std::size_t count = Lanes / reg::lanes;
+	typename reg::type r[count];
+
+	static KFINLINE float_pack load(const T* const p) {
+		float_pack x;
+		for(std::size_t i = 0; i != count; ++i) { x.r[i] = reg::load(p + i * reg::lanes); }
+		return x;
+	}
+	static KFINLINE float_pack fill(const T value) {
+		T values[Lanes];
+		std::fill(values, values + Lanes, value);
+		return load(values);
+	}
+	KFINLINE void store(T* const p) const {
+		for(std::size_t i = 0; i != count; ++i) { reg::store(p + i * reg::lanes, r[i]); }
+	}
+
+	// Apply fn to each register of a and b
+	template<typename Function>
+	static KFINLINE float_pack apply(const float_pack& a, const float_pack& b, Function fn) {
+		float_pack x;
+		for(std::size_t i = 0; i != count; ++i) { x.r[i] = fn(a.r[i], b.r[i]); }
+		return x;
+	}
+};
+
+// Number of lanes float_order::fast uses: four registers' worth, so the adds can overlap
+template<typename T>
+constexpr std::size_t fast_lanes = 4 * simd_float<T, simd_float_bytes<T>(64)>::lanes;
+
+// Combine the lanes of a pack pairwise with fn, in a fixed order
+template<typename T, std::size_t Lanes, typename Function>
+KINLINE T combine_lanes(const float_pack<T, Lanes>& pack, Function fn) {
+	T lanes[Lanes];
+	pack.store(lanes);
+	for(std::size_t width = Lanes / 2; width != 0; width /= 2) {
+		for(std::size_t i = 0; i != width; ++i) { lanes[i] = fn(lanes[i], lanes[i + width]); }
+	}
+	return lanes[0];
+}
+
+// Sum step(x, y) over packs of the count elements at a and b, in Lanes lanes.  The last, partial
+// pack is padded with zeros, which every step here maps to zero.
+template<typename T, std::size_t Lanes, typename Step>
+inline T sum_lanes(const T* const a, const T* const b, const std::size_t count, Step step) {
+	typedef float_pack<T, Lanes> pack;
+	typedef typename pack::reg reg;
+	const auto add = [](const typename reg::type x, const typename reg::type y) { return reg::add(x, y); };
+
+	pack acc = pack::fill(T(0));
+	std::size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		acc = pack::apply(acc, pack::apply(pack::load(a + i), pack::load(b + i), step), add);
+	}
+	if(i != count) {
+		T tailA[Lanes] = { }, tailB[Lanes] = { };
+		std::copy(a + i, a + count, tailA);
+		std::copy(b + i, b + count, tailB);
+		acc = pack::apply(acc, pack::apply(pack::load(tailA), pack::load(tailB), step), add);
+	}
+	return combine_lanes(acc, [](const T x, const T y) { return x + y; });
+}
+
+// sum_lanes() in the lanes that order calls for.  step takes a pair of registers, of whatever
+// width, and the simd_float traits for them.
+template<typename T, typename Step>
+inline T sum_floats(const T* const a, const T* const b, const std::size_t count, const float_order order, Step step) {
+	if(order == float_order::deterministic) {
+		typedef typename float_pack<T, 8>::reg reg;
+		return sum_lanes<T, 8>(a, b, count, [step](const typename reg::type x, const typename reg::type y) { return step(x, y, reg()); });
+	} else {
+		typedef typename float_pack<T, fast_lanes<T>>::reg reg;
+		return sum_lanes<T, fast_lanes<T>>(a, b, count, [step](const typename reg::type x, const typename reg::type y) { return step(x, y, reg()); });
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Integer kernels
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Sum of |a[i] - b[i]| over count bytes, 32 or 16 at a time with PSADBW
+inline std::uint64_t sum_absolute_differences(const std::uint8_t* const a, const std::uint8_t* const b, const std::size_t count) {
+	std::uint64_t total = 0;
+	std::size_t i = 0;
+#if defined(KANELIB_AVX2)
+	__m256i acc = _mm256_setzero_si256();
+	for(; i + 32 <= count; i += 32) {
+		acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i))));
+	}
+	alignas(32) std::uint64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+	total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(KANELIB_SSE2)
+	__m128i acc = _mm_setzero_si128();
+	for(; i + 16 <= count; i += 16) {
+		acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+	}
+	alignas(16) std::uint64_t lanes[2];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+	total = lanes[0] + lanes[1];
+#endif
+	for(; i != count; ++i) { total += (a[i] > b[i]) ? a[i] - b[i] : b[i] - a[i]; }
+	return total;
+}
+
+// Sum of count bytes: PSADBW against zero
+inline std::uint64_t sum_bytes(const std::uint8_t* const a, const std::size_t count) {
+	std::uint64_t total = 0;
+	std::size_t i = 0;
+#if defined(KANELIB_AVX2)
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc = zero;
+	for(; i + 32 <= count; i += 32) { acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), zero)); }
+	alignas(32) std::uint64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+	total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(KANELIB_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc = zero;
+	for(; i + 16 <= count; i += 16) { acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), zero)); }
+	alignas(16) std::uint64_t lanes[2];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+	total = lanes[0] + lanes[1];
+#endif
+	for(; i != count; ++i) { total += a[i]; }
+	return total;
+}
+
+// Sum of |a[i] - b[i]| over count 16-bit integers
+template<typename T>
+inline std::uint64_t sum_absolute_differences_16(const T* const a, const T* const b, const std::size_t count) {
+	static_assert(sizeof(T) == 2, "16-bit integers only");
+	std::uint64_t total = 0;
+	std::size_t i = 0;
+#if defined(KANELIB_AVX2)
+	// Differences fit in 16 unsigned bits, and two of them go into each 32-bit lane per step, so
+	// the lanes can take 32768 steps before they need emptying into 64-bit ones
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc64 = zero;
+	while(i + 16 <= count) {
+		const std::size_t blockEnd = std::min(count, i + 16 * std::size_t(32768));
+		__m256i acc32 = zero;
+		for(; i + 16 <= blockEnd; i += 16) {
+			const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+			const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+			__m256i d;
+			if constexpr(std::is_signed<T>::value) {
+				// Wraps, but is right taken as unsigned
+				d = _mm256_sub_epi16(_mm256_max_epi16(x, y), _mm256_min_epi16(x, y));
+			} else {
+				d = _mm256_or_si256(_mm256_subs_epu16(x, y), _mm256_subs_epu16(y, x));
+			}
+			acc32 = _mm256_add_epi32(acc32, _mm256_add_epi32(_mm256_unpacklo_epi16(d, zero), _mm256_unpackhi_epi16(d, zero)));
+		}
+		acc64 = _mm256_add_epi64(acc64, _mm256_add_epi64(_mm256_unpacklo_epi32(acc32, zero), _mm256_unpackhi_epi32(acc32, zero)));
+	}
+	alignas(32) std::uint64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc64);
+	total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+	for(; i != count; ++i) { total += std::uint64_t(std::abs(int(a[i]) - int(b[i]))); }
+	return total;
+}
+
+// Sum of |a[i] - b[i]| over count 32-bit integers
+template<typename T>
+inline std::uint64_t sum_absolute_differences_32(const T* const a, const T* const b, const std::size_t count) {
+	static_assert(sizeof(T) == 4, "32-bit integers only");
+	std::uint64_t total = 0;
+	std::size_t i = 0;
+#if defined(KANELIB_AVX512)
+	// Widen to 64 bits, eight at a time, so the differences can't overflow
+	const auto widen = [](const T* const p) {
+		const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		return std::is_signed<T>::value ? _mm512_cvtepi32_epi64(v) : _mm512_cvtepu32_epi64(v);
+	};
+	__m512i acc = _mm512_setzero_si512();
+	for(; i + 8 <= count; i += 8) {
+		acc = _mm512_add_epi64(acc, _mm512_abs_epi64(_mm512_sub_epi64(widen(a + i), widen(b + i))));
+	}
+	total = std::uint64_t(_mm512_reduce_add_epi64(acc));
+#elif defined(KANELIB_AVX2)
+	// Widen to 64 bits, four at a time, so the differences can't overflow
+	const auto widen = [](const T* const p) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		return std::is_signed<T>::value ? _mm256_cvtepi32_epi64(v) : _mm256_cvtepu32_epi64(v);
+	};
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc = zero;
+	for(; i + 4 <= count; i += 4) {
+		const __m256i d = _mm256_sub_epi64(widen(a + i), widen(b + i));
+		const __m256i sign = _mm256_cmpgt_epi64(zero, d);
+		acc = _mm256_add_epi64(acc, _mm256_sub_epi64(_mm256_xor_si256(d, sign), sign));
+	}
+	alignas(32) std::uint64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+	total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+	for(; i != count; ++i) {
+		const std::int64_t d = std::int64_t(a[i]) - std::int64_t(b[i]);
+		total += std::uint64_t((d < 0) ? -d : d);
+	}
+	return total;
+}
+
+// Types cumulative_difference() has a kernel for
+template<typename T>
+constexpr bool has_difference_kernel = std::is_same<T, std::uint8_t>::value || std::is_same<T, std::int16_t>::value || std::is_same<T, std::uint16_t>::value ||
+	std::is_same<T, std::int32_t>::value || std::is_same<T, std::uint32_t>::value || std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+template<typename T, typename U>
+using enable_if_difference_kernel_t = std::enable_if_t<std::is_same<std::remove_cv_t<T>, std::remove_cv_t<U>>::value && has_difference_kernel<std::remove_cv_t<T>>>;
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// cumulative_difference
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// init plus the sum of |*first1 - *first2| over equal-sized ranges: the sum of absolute
+// differences, or L1 distance
 template<typename InputIterator1, typename InputIterator2, typename T>
 __forceinline T cumulative_difference(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, T init = T()) {
 	while(first1 != last1) { init += std::abs(*first1 - *first2); ++first1; ++first2; }
 	return init;
 }
 
+// As above, vectorised, for contiguous ranges of bytes (PSADBW), 16-bit integers (AVX2), 32-bit
+// integers (AVX2 or AVX-512), and floats and doubles.  Integer differences are summed exactly, in
+// 64 bits, before being added to init; floating-point ones are summed in the elements' own type,
+// in the given order.
+template<typename E, typename F, typename T, typename = detail::enable_if_difference_kernel_t<E, F>>
+inline T cumulative_difference(E* const first1, E* const last1, F* const first2, T init, const float_order order) {
+	typedef std::remove_cv_t<E> value_type;
+	const std::size_t count = std::size_t(last1 - first1);
+	if constexpr(std::is_floating_point<value_type>::value) {
+		return init += T(detail::sum_floats(first1, first2, count, order, [](auto x, auto y, auto reg) { return reg.abs(reg.sub(x, y)); }));
+	} else if constexpr(sizeof(value_type) == 1) {
+		return init += T(detail::sum_absolute_differences(first1, first2, count));
+	} else if constexpr(sizeof(value_type) == 2) {
+		return init += T(detail::sum_absolute_differences_16(first1, first2, count));
+	} else {
+		return init += T(detail::sum_absolute_differences_32(first1, first2, count));
+	}
+}
+
+template<typename E, typename F, typename T = detail::sum_t<std::remove_cv_t<E>>, typename = detail::enable_if_difference_kernel_t<E, F>>
+inline T cumulative_difference(E* const first1, E* const last1, F* const first2, T init = T()) {
+	return kane::cumulative_difference(first1, last1, first2, init, float_order::fast);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Sums
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Sum of a contiguous range of numbers.  Bytes are summed with PSADBW; other integers with a
+// plain loop, which compilers vectorise themselves, since integer addition is associative.
+template<typename T>
+inline detail::sum_t<std::remove_cv_t<T>> sum(T* const first, T* const last, const float_order order = float_order::fast) {
+	typedef std::remove_cv_t<T> value_type;
+	typedef detail::sum_t<value_type> sum_type;
+	static_assert(std::is_arithmetic<value_type>::value, "kane::sum() sums numbers");
+	const std::size_t count = std::size_t(last - first);
+
+	if constexpr(std::is_floating_point<value_type>::value) {
+		return detail::sum_floats(first, first, count, order, [](auto x, auto, auto) { return x; });
+	} else if constexpr(std::is_same<value_type, std::uint8_t>::value) {
+		return detail::sum_bytes(first, count);
+	} else {
+		sum_type total = 0;
+		for(std::size_t i = 0; i != count; ++i) { total += sum_type(first[i]); }
+		return total;
+	}
+}
+
+// Sum of first1[i] * first2[i] over equal-sized contiguous ranges of numbers
+template<typename T, typename U, typename = detail::enable_if_arithmetic_pair_t<T, U>>
+inline detail::sum_t<std::remove_cv_t<T>> dot(T* const first1, T* const last1, U* const first2, const float_order order = float_order::fast) {
+	typedef std::remove_cv_t<T> value_type;
+	typedef detail::sum_t<value_type> sum_type;
+	const std::size_t count = std::size_t(last1 - first1);
+
+	if constexpr(std::is_floating_point<value_type>::value) {
+		return detail::sum_floats(first1, first2, count, order, [](auto x, auto y, auto reg) { return reg.mul(x, y); });
+	} else {
+		sum_type total = 0;
+		for(std::size_t i = 0; i != count; ++i) { total += sum_type(first1[i]) * sum_type(first2[i]); }
+		return total;
+	}
+}
+
+// Sum of the squares of a contiguous range of numbers
+template<typename T>
+inline detail::sum_t<std::remove_cv_t<T>> sum_of_squares(T* const first, T* const last, const float_order order = float_order::fast) {
+	typedef std::remove_cv_t<T> value_type;
+	typedef detail::sum_t<value_type> sum_type;
+	static_assert(std::is_arithmetic<value_type>::value, "kane::sum_of_squares() sums numbers");
+	const std::size_t count = std::size_t(last - first);
+
+	if constexpr(std::is_floating_point<value_type>::value) {
+		return detail::sum_floats(first, first, count, order, [](auto x, auto, auto reg) { return reg.mul(x, x); });
+	} else {
+		sum_type total = 0;
+		for(std::size_t i = 0; i != count; ++i) { total += sum_type(first[i]) * sum_type(first[i]); }
+		return total;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// min_max
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Lowest and highest elements of a non-empty contiguous range of numbers, in one pass.  Exact
+// either way, so there's no float_order.  NaNs are skipped, unless the first element is one, in
+// which case both results are NaNs.  (Which of -0 and +0 comes back when both are there is
+// unspecified.)
+template<typename T>
+inline min_max_result<std::remove_cv_t<T>> min_max(T* const first, T* const last) {
+	typedef std::remove_cv_t<T> value_type;
+	static_assert(std::is_arithmetic<value_type>::value, "kane::min_max() compares numbers");
+	_ASSERTE(first != last);
+	const std::size_t count = std::size_t(last - first);
+
+	if constexpr(std::is_floating_point<value_type>::value) {
+		typedef detail::float_pack<value_type, detail::fast_lanes<value_type>> pack;
+		typedef typename pack::reg reg;
+		constexpr std::size_t lanes = detail::fast_lanes<value_type>;
+		const auto min = [](const typename reg::type x, const typename reg::type y) { return reg::min(x, y); };
+		const auto max = [](const typename reg::type x, const typename reg::type y) { return reg::max(x, y); };
+
+		// MINPS and friends return their second operand if either is a NaN, so the running results
+		// go second: a NaN element then leaves them alone, and only a NaN first element gets in
+		pack lo = pack::fill(*first), hi = lo;
+		std::size_t i = 0;
+		for(; i + lanes <= count; i += lanes) {
+			const pack x = pack::load(first + i);
+			lo = pack::apply(x, lo, min);
+			hi = pack::apply(x, hi, max);
+		}
+		if(i != count) {
+			// Pad with the first element, which can't change the answer
+			value_type tail[lanes];
+			std::fill(tail, tail + lanes, *first);
+			std::copy(first + i, last, tail);
+			const pack x = pack::load(tail);
+			lo = pack::apply(x, lo, min);
+			hi = pack::apply(x, hi, max);
+		}
+		typedef detail::scalar_float<value_type> scalar;
+		return { detail::combine_lanes(lo, [](const value_type x, const value_type y) { return scalar::min(x, y); }),
+				 detail::combine_lanes(hi, [](const value_type x, const value_type y) { return scalar::max(x, y); }) };
+	} else {
+		value_type lo = *first, hi = *first;
+		for(std::size_t i = 1; i != count; ++i) {
+			lo = (first[i] < lo) ? first[i] : lo;
+			hi = (first[i] > hi) ? first[i] : hi;
+		}
+		return { lo, hi };
+	}
+}
+
 }
\ No newline at end of file
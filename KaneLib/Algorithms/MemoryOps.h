@@ -0,0 +1,336 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Memory operations
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Low-level kernels for filling, copying and comparing raw memory, used by array_container_base to
+// construct, assign and relocate trivially copyable elements in bulk, and by the comparisons in
+// Algorithms.h.  They use the widest vector registers available at compile time (see KANELIB_SSE2
+// and friends in Config.h), and fall back on memcpy() tricks otherwise.
+#pragma once
+
+#include <KaneLib/Config.h>
+#include <KaneLib/Utility/Bits.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(KANELIB_AVX2) || defined(KANELIB_AVX512)
+#include <immintrin.h>
+#elif defined(KANELIB_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace kane {
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// simd_vector
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// The widest integer vector register available, and the loads and stores the kernels need.
+#if defined(KANELIB_AVX512)
+struct simd_vector {
+	typedef __m512i type;
+	static constexpr std::size_t size = 64;
+	static KFINLINE type load(const void* const p) { return _mm512_loadu_si512(p); }
+	static KFINLINE void store(void* const p, const type v) { _mm512_storeu_si512(p, v); }
+	static KFINLINE void store_aligned(void* const p, const type v) { _mm512_store_si512(p, v); }
+	static KFINLINE void stream(void* const p, const type v) { _mm512_stream_si512(static_cast<type*>(p), v); }
+};
+#elif defined(KANELIB_AVX2)
+struct simd_vector {
+	typedef __m256i type;
+	static constexpr std::size_t size = 32;
+	static KFINLINE type load(const void* const p) { return _mm256_loadu_si256(static_cast<const type*>(p)); }
+	static KFINLINE void store(void* const p, const type v) { _mm256_storeu_si256(static_cast<type*>(p), v); }
+	static KFINLINE void store_aligned(void* const p, const type v) { _mm256_store_si256(static_cast<type*>(p), v); }
+	static KFINLINE void stream(void* const p, const type v) { _mm256_stream_si256(static_cast<type*>(p), v); }
+};
+#elif defined(KANELIB_SSE2)
+struct simd_vector {
+	typedef __m128i type;
+	static constexpr std::size_t size = 16;
+	static KFINLINE type load(const void* const p) { return _mm_loadu_si128(static_cast<const type*>(p)); }
+	static KFINLINE void store(void* const p, const type v) { _mm_storeu_si128(static_cast<type*>(p), v); }
+	static KFINLINE void store_aligned(void* const p, const type v) { _mm_store_si128(static_cast<type*>(p), v); }
+	static KFINLINE void stream(void* const p, const type v) { _mm_stream_si128(static_cast<type*>(p), v); }
+};
+#endif
+
+#if defined(KANELIB_SSE2)
+#define KANELIB_HAS_SIMD_VECTOR 1
+// Make streaming stores visible to other threads before anything that follows
+KFINLINE void stream_fence() { _mm_sfence(); }
+#endif
+
+// Fill bytes of memory at dest by repeating the size-byte pattern at value
+KINLINE void fill_pattern(unsigned char* const dest, const std::size_t bytes, const unsigned char* const value, const std::size_t size) {
+#ifdef KANELIB_HAS_SIMD_VECTOR
+	typedef simd_vector simd;
+	constexpr std::size_t V = simd::size;
+
+	// Too small for even one vector store
+	if(bytes < V) {
+		for(std::size_t i = 0; i < bytes; i += size) { std::memcpy(dest + i, value, size); }
+		return;
+	}
+
+	// Two vectors' worth of the pattern, so we can load a vector of it starting at any phase
+	alignas(64) unsigned char pattern[2 * V];
+	for(std::size_t i = 0; i < 2 * V; i += size) { std::memcpy(pattern + i, value, size); }
+	const simd::type head = simd::load(pattern);
+
+	// Unaligned stores at both ends.  bytes and V are both multiples of size, so the pattern is
+	// in phase at either end.
+	unsigned char* const end = dest + bytes;
+	simd::store(dest, head);
+	simd::store(end - V, head);
+
+	// Aligned stores in between.  The first aligned address may not be a whole number of elements
+	// from dest (a 16-byte type may only be 8-byte aligned), so load the pattern in phase with it.
+	unsigned char* p = reinterpret_cast<unsigned char*>((reinterpret_cast<std::uintptr_t>(dest) + V - 1) & ~std::uintptr_t(V - 1));
+	unsigned char* const last = reinterpret_cast<unsigned char*>(reinterpret_cast<std::uintptr_t>(end) & ~std::uintptr_t(V - 1));
+	const simd::type body = simd::load(pattern + std::size_t(p - dest) % size);
+
+	if(bytes >= KANELIB_STREAMING_THRESHOLD) {
+		// Huge fill, so don't drag it all through the cache
+		for(; p < last; p += V) { simd::stream(p, body); }
+		stream_fence();
+	} else {
+		for(; p < last; p += V) { simd::store_aligned(p, body); }
+	}
+
+#else
+	// No vector registers to speak of, so let memcpy() do the work: copy in one element, then keep
+	// doubling the filled region by copying it onto the end of itself
+	if(bytes == 0) { return; }
+	std::memcpy(dest, value, size);
+	std::size_t filled = size;
+	while(filled < bytes) {
+		const std::size_t chunk = (filled < bytes - filled) ? filled : (bytes - filled);
+		std::memcpy(dest + filled, dest, chunk);
+		filled += chunk;
+	}
+#endif
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Fill
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// True if T can be filled with fast_fill_n(): it has to be trivially copyable, and its size has
+// to divide a vector register.
+template<typename T>
+struct can_fast_fill : public std::bool_constant<std::is_trivially_copyable<T>::value &&
+	(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8 || sizeof(T) == 16)> { };
+
+// Fill [first, first + count) with copies of value by copying its bytes, whether or not the
+// range has been initialised.  value may be inside the range.  Fills of at least
+// KANELIB_STREAMING_THRESHOLD bytes use non-temporal stores.  Returns first + count.
+template<typename T>
+inline T* fast_fill_n(T* const first, const std::size_t count, const T& value) {
+	static_assert(can_fast_fill<T>::value, "fast_fill_n requires a trivially copyable type of 1, 2, 4, 8 or 16 bytes");
+	// An empty vector's first is NULL, which even a zero-byte memset() can't take
+	if(count == 0) { return first; }
+
+	// Take a copy of the value before we start overwriting things
+	unsigned char valueBytes[sizeof(T)];
+	std::memcpy(valueBytes, &value, sizeof(T));
+
+	unsigned char* const dest = reinterpret_cast<unsigned char*>(first);
+	const std::size_t bytes = count * sizeof(T);
+
+	// The C library's memset() is as good as it gets for bytes, except for streaming
+	if constexpr(sizeof(T) == 1) {
+		if(bytes < KANELIB_STREAMING_THRESHOLD) {
+			std::memset(dest, valueBytes[0], bytes);
+			return first + count;
+		}
+	}
+
+	detail::fill_pattern(dest, bytes, valueBytes, sizeof(T));
+	return first + count;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Streaming copy
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// How far ahead of the copy, in bytes, stream_copy() prefetches the source
+#ifndef KANELIB_PREFETCH_DISTANCE
+#define KANELIB_PREFETCH_DISTANCE 1024
+#endif
+
+// Copy bytes from src to dest, which mustn't overlap, with non-temporal stores.  The destination 
+// goes straight to memory instead of through the cache, and the source is prefetched with a 
+// non-temporal hint, so a copy much larger than the cache doesn't evict everybody else's data 
+// from it.  That makes it slower than memcpy() for anything that's going to be used again soon,
+// so only use it for huge blocks; see KANELIB_STREAMING_THRESHOLD.  Returns dest.
+inline void* stream_copy(void* const dest, const void* const src, const std::size_t bytes) {
+#ifdef KANELIB_HAS_SIMD_VECTOR
+	typedef detail::simd_vector simd;
+	constexpr std::size_t V = simd::size;
+	constexpr std::size_t line = (KANELIB_CACHE_LINE_SIZE > V) ? KANELIB_CACHE_LINE_SIZE : V;
+
+	// Not worth it for a handful of lines
+	if(bytes < 4 * line) { return std::memcpy(dest, src, bytes); }
+
+	unsigned char* d = static_cast<unsigned char*>(dest);
+	const unsigned char* s = static_cast<const unsigned char*>(src);
+
+	// Ordinary copy up to the first aligned destination address
+	const std::size_t head = (V - (reinterpret_cast<std::uintptr_t>(d) & (V - 1))) & (V - 1);
+	std::memcpy(d, s, head);
+	d += head;
+	s += head;
+	std::size_t remaining = bytes - head;
+
+	// A cache line at a time, prefetching one source line per line stored.  (Prefetching past the
+	// end of the source is harmless; prefetches never fault.)
+	for(; remaining >= line; remaining -= line, d += line, s += line) {
+		_mm_prefetch(reinterpret_cast<const char*>(s + KANELIB_PREFETCH_DISTANCE), _MM_HINT_NTA);
+		for(std::size_t i = 0; i < line; i += V) { simd::stream(d + i, simd::load(s + i)); }
+	}
+
+	// Whatever's left over, then make sure the streamed lines are visible before anyone else looks
+	std::memcpy(d, s, remaining);
+	detail::stream_fence();
+	return dest;
+#else
+	return std::memcpy(dest, src, bytes);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Mismatch
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Offset of the first byte that differs between a and b, or bytes if they're the same.  Compares
+// 64 bytes a step with AVX2 (32 with SSE2): a vector compare, a movemask to pull out one bit per
+// byte, and a bit scan for the first mismatch.  The tail is one last vector compare overlapping
+// what's already been checked, so there's no byte-by-byte loop unless the whole thing is smaller
+// than a vector.
+inline std::size_t mismatch_bytes(const void* const a, const void* const b, const std::size_t bytes) noexcept {
+	const unsigned char* const p = static_cast<const unsigned char*>(a);
+	const unsigned char* const q = static_cast<const unsigned char*>(b);
+	std::size_t i = 0;
+
+#if defined(KANELIB_AVX2)
+	// Mask of bytes that differ in the 32 at offset
+	const auto differ32 = [p, q](const std::size_t offset) {
+		const __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + offset)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + offset)));
+		return ~std::uint32_t(_mm256_movemask_epi8(eq));
+	};
+	if(bytes >= 32) {
+		for(; i + 64 <= bytes; i += 64) {
+			const std::uint64_t mask = std::uint64_t(differ32(i)) | (std::uint64_t(differ32(i + 32)) << 32);
+			if(mask) { return i + kane::bit_scan_forward(mask); }
+		}
+		for(; i + 32 <= bytes; i += 32) {
+			const std::uint32_t mask = differ32(i);
+			if(mask) { return i + kane::bit_scan_forward(mask); }
+		}
+		if(i == bytes) { return bytes; }
+		const std::uint32_t mask = differ32(bytes - 32);
+		return mask ? bytes - 32 + kane::bit_scan_forward(mask) : bytes;
+	}
+#endif
+
+#if defined(KANELIB_SSE2)
+	// Mask of bytes that differ in the 16 at offset
+	const auto differ16 = [p, q](const std::size_t offset) {
+		const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + offset)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + offset)));
+		return ~std::uint32_t(_mm_movemask_epi8(eq)) & 0xFFFFu;
+	};
+	if(bytes >= 16) {
+		for(; i + 32 <= bytes; i += 32) {
+			const std::uint32_t mask = differ16(i) | (differ16(i + 16) << 16);
+			if(mask) { return i + kane::bit_scan_forward(mask); }
+		}
+		for(; i + 16 <= bytes; i += 16) {
+			const std::uint32_t mask = differ16(i);
+			if(mask) { return i + kane::bit_scan_forward(mask); }
+		}
+		if(i == bytes) { return bytes; }
+		const std::uint32_t mask = differ16(bytes - 16);
+		return mask ? bytes - 16 + kane::bit_scan_forward(mask) : bytes;
+	}
+#endif
+
+	// A word at a time; on a little-endian machine, the lowest set bit of the difference is in the
+	// first byte that differs
+	for(; i + 8 <= bytes; i += 8) {
+		std::uint64_t x, y;
+		std::memcpy(&x, p + i, 8);
+		std::memcpy(&y, q + i, 8);
+		if(x != y) { return i + kane::bit_scan_forward(x ^ y) / 8; }
+	}
+	for(; i != bytes; ++i) {
+		if(p[i] != q[i]) { return i; }
+	}
+	return bytes;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Byte sets
+///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace detail {
+
+// A set of byte values, for scanning text for the first byte in (or not in) the set, such as the
+// next delimiter or the start of the next token.  Sets of up to max_simd_bytes values are scanned
+// a vector at a time, comparing against each value and combining the results into a bit mask, one
+// bit per byte; bigger sets, and the last few bytes of the text, go through a lookup table.
+class byte_set {
+public:
+	static constexpr std::size_t max_simd_bytes = 8;
+
+	byte_set(const char* const values, const std::size_t count) noexcept : m_simdCount(count <= max_simd_bytes ? count : 0) {
+		std::memset(m_table, 0, sizeof(m_table));
+		for(std::size_t i = 0; i != count; ++i) {
+			m_table[static_cast<unsigned char>(values[i])] = true;
+			if(i < max_simd_bytes) { m_values[i] = values[i]; }
+		}
+	}
+
+	bool contains(const char c) const noexcept { return m_table[static_cast<unsigned char>(c)]; }
+
+	// First byte in [p, end) that is (or isn't) in the set, or end
+	const char* find_first_in(const char* p, const char* const end) const noexcept { return find<true>(p, end); }
+	const char* find_first_not_in(const char* p, const char* const end) const noexcept { return find<false>(p, end); }
+
+private:
+	template<bool In>
+	const char* find(const char* p, const char* const end) const noexcept {
+#if defined(KANELIB_AVX2)
+		if(m_simdCount != 0) {
+			for(; end - p >= 32; p += 32) {
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				__m256i matches = _mm256_setzero_si256();
+				for(std::size_t i = 0; i != m_simdCount; ++i) { matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(m_values[i]))); }
+				const std::uint32_t mask = In ? std::uint32_t(_mm256_movemask_epi8(matches)) : ~std::uint32_t(_mm256_movemask_epi8(matches));
+				if(mask) { return p + kane::bit_scan_forward(mask); }
+			}
+		}
+#elif defined(KANELIB_SSE2)
+		if(m_simdCount != 0) {
+			for(; end - p >= 16; p += 16) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				__m128i matches = _mm_setzero_si128();
+				for(std::size_t i = 0; i != m_simdCount; ++i) { matches = _mm_or_si128(matches, _mm_cmpeq_epi8(v, _mm_set1_epi8(m_values[i]))); }
+				const std::uint32_t mask = (In ? std::uint32_t(_mm_movemask_epi8(matches)) : ~std::uint32_t(_mm_movemask_epi8(matches))) & 0xFFFFu;
+				if(mask) { return p + kane::bit_scan_forward(mask); }
+			}
+		}
+#endif
+		while(p != end && contains(*p) != In) { ++p; }
+		return p;
+	}
+
+	bool m_table[256];
+	char m_values[max_simd_bytes];
+	std::size_t m_simdCount;	// 0 if the set's too big to scan with vectors
+};
+
+}
+
+}
@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Parallel algorithms
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Bulk operations split across threads.  By default, the work goes to kane::default_thread_pool()
+// (see Threading/ThreadPool.h), but an application with its own thread pool or task system can
+// route it there instead with set_parallel_executor().
+//
+// parallel_for() and parallel_reduce(), whose work can be uneven, run on
+// kane::default_task_scheduler() instead (see Threading/TaskScheduler.h), which balances it by
+// work stealing.
+#pragma once
+
+#include <KaneLib/Config.h>
+#include <KaneLib/Algorithms/MemoryOps.h>
+#include <KaneLib/Threading/TaskScheduler.h>
+#include <KaneLib/Threading/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Size in bytes from which containers that opt in with kane::use_parallel_copy copy and relocate
+// their elements across threads
+#ifndef KANELIB_PARALLEL_COPY_THRESHOLD
+#define KANELIB_PARALLEL_COPY_THRESHOLD (std::size_t(64) << 20)
+#endif
+
+// Size in bytes of each piece of a parallel copy
+#ifndef KANELIB_PARALLEL_COPY_CHUNK
+#define KANELIB_PARALLEL_COPY_CHUNK (std::size_t(4) << 20)
+#endif
+
+namespace kane {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Executors
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A parallel executor calls task(context, i) for every i in [0, count), as concurrently as it
+// likes, and returns once they've all finished.  Tasks don't throw.
+typedef void (*parallel_executor)(std::size_t count, void (*task)(void* context, std::size_t i), void* context);
+
+namespace detail {
+	inline std::atomic<parallel_executor>& parallel_executor_slot() noexcept {
+		static std::atomic<parallel_executor> executor(NULL);
+		return executor;
+	}
+}
+
+// Route the library's parallel work to executor, or back to default_thread_pool() if it's NULL
+inline void set_parallel_executor(const parallel_executor executor) noexcept {
+	detail::parallel_executor_slot().store(executor, std::memory_order_release);
+}
+inline parallel_executor get_parallel_executor() noexcept {
+	return detail::parallel_executor_slot().load(std::memory_order_acquire);
+}
+
+// Call fn(i) for each i in [0, count) on the current executor, and wait for them all
+template<typename Function>
+inline void parallel_execute(const std::size_t count, Function&& fn) {
+	typedef std::remove_reference_t<Function> function_type;
+	const parallel_executor executor = get_parallel_executor();
+	if(executor) {
+		executor(count, [](void* const context, const std::size_t i) { (*static_cast<function_type*>(context))(i); },
+			const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+	} else {
+		default_thread_pool().run(count, fn);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Page slices
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Split the count elements starting at first into slices of about KANELIB_PARALLEL_COPY_CHUNK 
+// bytes, and call fn(begin, end) with each slice's element indices on the current executor.  The
+// slices start on page boundaries (or as close as an element straddling one allows), so when the
+// memory is fresh from the OS, each page is first touched by the thread that fills it, and on a
+// NUMA machine it gets placed on that thread's node rather than all on the caller's.
+template<typename T, typename Function>
+inline void parallel_for_pages(T* const first, const std::size_t count, Function&& fn) {
+	// Not worth a system call to find out.  4KB is the smallest page size anywhere we run, and 
+	// lining up with that also lines up with anything bigger often enough.
+	constexpr std::size_t page = 4096;
+	constexpr std::size_t chunk = KANELIB_PARALLEL_COPY_CHUNK;
+	const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(first);
+	const std::size_t pieces = (count * sizeof(T) + chunk - 1) / chunk;
+
+	// Index of the first element starting at or after the first page boundary at least 
+	// piece * chunk bytes in
+	const auto boundary = [=](const std::size_t piece) {
+		const std::uintptr_t target = (base + piece * chunk + page - 1) & ~std::uintptr_t(page - 1);
+		return std::min(std::size_t((target - base + sizeof(T) - 1) / sizeof(T)), count);
+	};
+
+	parallel_execute(pieces, [&](const std::size_t i) {
+		const std::size_t begin = (i == 0) ? 0 : boundary(i);
+		const std::size_t end = (i + 1 == pieces) ? count : boundary(i + 1);
+		if(begin < end) { fn(begin, end); }
+	});
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Copy
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Copy bytes from src to dest, which mustn't overlap, in KANELIB_PARALLEL_COPY_CHUNK pieces on the
+// current executor.  A single thread can't saturate memory bandwidth on most machines, so for
+// multi-gigabyte copies this is several times faster than memcpy().  Each piece is copied with
+// stream_copy(), so the copy doesn't flush everyone's caches either.  Returns dest.
+inline void* parallel_copy(void* const dest, const void* const src, const std::size_t bytes) {
+	constexpr std::size_t chunk = KANELIB_PARALLEL_COPY_CHUNK;
+	unsigned char* const d = static_cast<unsigned char*>(dest);
+	const unsigned char* const s = static_cast<const unsigned char*>(src);
+
+	parallel_execute((bytes + chunk - 1) / chunk, [=](const std::size_t i) {
+		const std::size_t offset = i * chunk;
+		kane::stream_copy(d + offset, s + offset, std::min(chunk, bytes - offset));
+	});
+	return dest;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Loops
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Loops over a contiguous range, given either as raw pointers or as a container with data() and
+// size() (kane::vector, kane::static_vector, std::vector...), load-balanced by work stealing on 
+// kane::default_task_scheduler().  Threads split the range between them as they run out of work,
+// so elements that take wildly different times to process still spread out evenly.
+//
+// grain is the most elements a thread processes between checks for idle threads to share with,
+// and the smallest piece the range gets split into.  Smaller grains balance better, larger ones
+// cost less overhead; the default, 0, picks about 64 pieces per thread.
+
+namespace detail {
+	inline std::size_t default_grain(const std::size_t count, const task_scheduler& scheduler) noexcept {
+		return std::max<std::size_t>(count / (std::size_t(scheduler.concurrency()) * 64), 1);
+	}
+}
+
+// Call fn(element) for each element of [first, last)
+template<typename T, typename Function>
+inline void parallel_for(T* const first, T* const last, Function&& fn, std::size_t grain = 0) {
+	task_scheduler& scheduler = default_task_scheduler();
+	const std::size_t count = std::size_t(last - first);
+	if(grain == 0) { grain = detail::default_grain(count, scheduler); }
+
+	scheduler.run(count, grain, [first, &fn](unsigned, const std::size_t begin, const std::size_t end) {
+		T* const stop = first + end;
+		for(T* p = first + begin; p != stop; ++p) { fn(*p); }
+	});
+}
+
+template<typename Container, typename Function>
+inline void parallel_for(Container& c, Function&& fn, const std::size_t grain = 0) {
+	kane::parallel_for(c.data(), c.data() + c.size(), std::forward<Function>(fn), grain);
+}
+
+// Combine init and every element of [first, last) with op, like std::reduce(): op must be
+// associative and commutative, since each thread folds the pieces it happens to get, and the
+// threads' totals are then folded into init.  op is called as op(U, element) and op(U, U), so
+// elements must convert to U.  Floating-point results can vary (slightly) from run to run.
+template<typename T, typename U, typename BinaryOp>
+inline U parallel_reduce(const T* const first, const T* const last, U init, BinaryOp op, std::size_t grain = 0) {
+	task_scheduler& scheduler = default_task_scheduler();
+	const std::size_t count = std::size_t(last - first);
+	if(grain == 0) { grain = detail::default_grain(count, scheduler); }
+
+	// Each slot's running total, on its own cache line
+	struct alignas(KANELIB_CACHE_LINE_SIZE) partial { std::optional<U> value; };
+	std::unique_ptr<partial[]> partials(new partial[scheduler.concurrency()]);
+
+	scheduler.run(count, grain, [first, &op, &partials](const unsigned slot, const std::size_t begin, const std::size_t end) {
+		U sum = static_cast<U>(first[begin]);
+		for(const T* p = first + begin + 1, *stop = first + end; p != stop; ++p) { sum = op(std::move(sum), *p); }
+
+		std::optional<U>& total = partials[slot].value;
+		if(total) {
+			*total = op(std::move(*total), std::move(sum));
+		} else {
+			total.emplace(std::move(sum));
+		}
+	});
+
+	for(unsigned i = 0, n = scheduler.concurrency(); i != n; ++i) {
+		if(partials[i].value) { init = op(std::move(init), std::move(*partials[i].value)); }
+	}
+	return init;
+}
+
+template<typename Container, typename U, typename BinaryOp>
+inline U parallel_reduce(const Container& c, U init, BinaryOp op, const std::size_t grain = 0) {
+	return kane::parallel_reduce(c.data(), c.data() + c.size(), std::move(init), std::move(op), grain);
+}
+
+}
@@ -0,0 +1,249 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Radix sort
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Stable LSD radix sort for vectors of integers and floating-point numbers, or of trivially
+// copyable records sorted by an arithmetic key:
+//
+//   kane::radix_sort(ids);											// kane::vector<uint32_t>
+//   kane::radix_sort(hits, [](const hit& h) { return h.distance; });	// by a float member
+//   kane::radix_sort(kane::par, ids);								// across threads
+//
+// Keys are mapped to unsigned integers that sort the same way (see radix_ordered_key()), and then
+// sorted a byte at a time, least significant first, bouncing between the vector and a scratch
+// vector of the same size.  One read of the keys up front counts every byte's histogram, and
+// bytes where every key has the same value (the high bytes of small numbers, say) are skipped.
+// That's O(n) work per byte of key, against std::sort()'s O(n log n) comparisons, so it wins by a
+// growing margin as n grows.  Below 64 elements (radix_insertion_threshold), where counting every
+// byte's histogram costs more than it saves, it's an insertion sort.
+//
+// The scratch vector is a copy of the vector's own type, using its allocator, so it comes from
+// the same place (huge pages, reserved memory...) as the elements.
+//
+// The parallel version splits the elements into blocks, and for each byte, counts every block's
+// histogram in parallel, works out where each block's elements of each byte value go, and then
+// scatters the blocks in parallel, so it stays stable.  It runs on the current executor (see
+// Algorithms/Parallel.h), and only from KANELIB_PARALLEL_SORT_THRESHOLD elements; below that, it
+// sorts serially.
+//
+// Floating-point keys sort -0 before +0, and NaNs to the ends: negative ones (in the sign bit
+// sense) first, positive ones last.
+#pragma once
+
+#include <KaneLib/Config.h>
+#include <KaneLib/Algorithms/Parallel.h>
+#include <KaneLib/Utility/Utility.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Number of elements from which radix_sort(kane::par, ...) sorts across threads
+#ifndef KANELIB_PARALLEL_SORT_THRESHOLD
+#define KANELIB_PARALLEL_SORT_THRESHOLD (std::size_t(1) << 18)
+#endif
+
+namespace kane {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Keys
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Map an integer or floating-point key to an unsigned integer of the same size that sorts in the
+// same order
+template<typename Key>
+KFINLINE auto radix_ordered_key(const Key key) noexcept {
+	static_assert(std::is_arithmetic<Key>::value && !std::is_same<Key, bool>::value, "radix_sort() keys must be integers or floating-point numbers");
+
+	if constexpr(std::is_floating_point<Key>::value) {
+		static_assert(sizeof(Key) == 4 || sizeof(Key) == 8, "radix_sort() only supports 32- and 64-bit floating-point keys");
+		typedef std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t> bits_type;
+		constexpr bits_type signBit = bits_type(1) << (sizeof(Key) * 8 - 1);
+		bits_type bits;
+		std::memcpy(&bits, &key, sizeof(Key));
+		// Negative numbers sort backwards, so flip all their bits; positive ones just need to
+		// come after them
+		return bits_type(bits ^ ((bits & signBit) ? bits_type(~bits_type(0)) : signBit));
+	} else {
+		typedef std::make_unsigned_t<Key> bits_type;
+		if constexpr(std::is_signed<Key>::value) {
+			return bits_type(bits_type(key) ^ (bits_type(1) << (sizeof(Key) * 8 - 1)));
+		} else {
+			return bits_type(key);
+		}
+	}
+}
+
+namespace detail {
+
+	// Sorts by the value itself
+	struct radix_identity_key {
+		template<typename T>
+		KFINLINE const T& operator()(const T& val) const noexcept { return val; }
+	};
+
+	template<typename T, typename KeyFunction>
+	using radix_bits_t = decltype(kane::radix_ordered_key(std::declval<KeyFunction&>()(std::declval<const T&>())));
+
+	constexpr unsigned radix_digit_bits = 8;
+	constexpr std::size_t radix_buckets = std::size_t(1) << radix_digit_bits;
+
+	// Below this many elements, insertion sort beats counting
+	constexpr std::size_t radix_insertion_threshold = 64;
+
+	template<typename Bits>
+	KFINLINE std::size_t radix_digit(const Bits bits, const unsigned digit) noexcept {
+		return std::size_t(bits >> (digit * radix_digit_bits)) & (radix_buckets - 1);
+	}
+
+	// Stable insertion sort by key
+	template<typename T, typename KeyFunction>
+	inline void radix_insertion_sort(T* const first, T* const last, KeyFunction& key) {
+		for(T* i = first + 1; i < last; ++i) {
+			const T val = *i;
+			const auto bits = kane::radix_ordered_key(key(val));
+			T* j = i;
+			for(; j != first && bits < kane::radix_ordered_key(key(j[-1])); --j) { *j = j[-1]; }
+			*j = val;
+		}
+	}
+
+	// Sort the count elements at data, using count elements of scratch space
+	template<typename T, typename KeyFunction>
+	inline void radix_sort(T* const data, T* const scratch, const std::size_t count, KeyFunction& key) {
+		typedef radix_bits_t<T, KeyFunction> bits_type;
+		constexpr unsigned digits = sizeof(bits_type);
+
+		// Every digit's histogram in one pass
+		std::size_t histograms[digits][radix_buckets] = { };
+		for(const T* p = data, *end = data + count; p != end; ++p) {
+			const bits_type bits = kane::radix_ordered_key(key(*p));
+			for(unsigned d = 0; d != digits; ++d) { ++histograms[d][radix_digit(bits, d)]; }
+		}
+
+		T* src = data;
+		T* dest = scratch;
+		for(unsigned d = 0; d != digits; ++d) {
+			std::size_t* const histogram = histograms[d];
+			// Everything has the same digit here, so this pass wouldn't move anything
+			if(histogram[radix_digit(kane::radix_ordered_key(key(*data)), d)] == count) { continue; }
+
+			// Turn the counts into starting offsets
+			std::size_t offset = 0;
+			for(std::size_t b = 0; b != radix_buckets; ++b) {
+				const std::size_t n = histogram[b];
+				histogram[b] = offset;
+				offset += n;
+			}
+
+			for(const T* p = src, *end = src + count; p != end; ++p) {
+				dest[histogram[radix_digit(kane::radix_ordered_key(key(*p)), d)]++] = *p;
+			}
+			std::swap(src, dest);
+		}
+
+		if(src != data) { std::memcpy(data, src, count * sizeof(T)); }
+	}
+
+	// As above, across threads
+	template<typename T, typename KeyFunction>
+	inline void parallel_radix_sort(T* const data, T* const scratch, const std::size_t count, KeyFunction& key) {
+		typedef radix_bits_t<T, KeyFunction> bits_type;
+		constexpr unsigned digits = sizeof(bits_type);
+
+		// Enough blocks to go round, but each big enough that its histogram is worth counting
+		const std::size_t blocks = std::min<std::size_t>(std::max<std::size_t>(count >> 16, 1), 64);
+		const std::size_t blockSize = (count + blocks - 1) / blocks;
+		std::unique_ptr<std::size_t[][radix_buckets]> histograms(new std::size_t[blocks][radix_buckets]);
+
+		T* src = data;
+		T* dest = scratch;
+		for(unsigned d = 0; d != digits; ++d) {
+			parallel_execute(blocks, [&](const std::size_t block) {
+				std::size_t* const histogram = histograms[block];
+				std::fill(histogram, histogram + radix_buckets, std::size_t(0));
+				for(const T* p = src + block * blockSize, *end = src + std::min(count, (block + 1) * blockSize); p < end; ++p) {
+					++histogram[radix_digit(kane::radix_ordered_key(key(*p)), d)];
+				}
+			});
+
+			// Each block's elements with a given digit go after those with smaller digits, and after
+			// earlier blocks' elements with the same digit
+			std::size_t offset = 0;
+			bool trivial = false;
+			for(std::size_t b = 0; b != radix_buckets; ++b) {
+				const std::size_t bucketStart = offset;
+				for(std::size_t block = 0; block != blocks; ++block) {
+					const std::size_t n = histograms[block][b];
+					histograms[block][b] = offset;
+					offset += n;
+				}
+				if(offset - bucketStart == count) { trivial = true; }
+			}
+			if(trivial) { continue; }
+
+			parallel_execute(blocks, [&](const std::size_t block) {
+				std::size_t* const offsets = histograms[block];
+				for(const T* p = src + block * blockSize, *end = src + std::min(count, (block + 1) * blockSize); p < end; ++p) {
+					dest[offsets[radix_digit(kane::radix_ordered_key(key(*p)), d)]++] = *p;
+				}
+			});
+			std::swap(src, dest);
+		}
+
+		if(src != data) { kane::parallel_copy(data, src, count * sizeof(T)); }
+	}
+
+	template<bool Parallel, typename Vector, typename KeyFunction>
+	inline void radix_sort_vector(Vector& v, KeyFunction& key) {
+		typedef typename Vector::value_type value_type;
+		static_assert(std::is_trivially_copyable<value_type>::value, "radix_sort() moves elements with memcpy(), so they must be trivially copyable");
+
+		const std::size_t count = v.size();
+		value_type* const data = v.data();
+		if(count < radix_insertion_threshold) {
+			if(count > 1) { radix_insertion_sort(data, data + count, key); }
+			return;
+		}
+
+		Vector scratch(v.size(), v.get_allocator());
+		if(Parallel && count >= KANELIB_PARALLEL_SORT_THRESHOLD) {
+			parallel_radix_sort(data, scratch.data(), count, key);
+		} else {
+			radix_sort(data, scratch.data(), count, key);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Sorting
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Sort a vector of integers or floating-point numbers
+template<typename Vector>
+inline void radix_sort(Vector& v) {
+	detail::radix_identity_key key;
+	detail::radix_sort_vector<false>(v, key);
+}
+
+// Sort a vector of trivially copyable elements by key(element), which returns an integer or
+// floating-point number
+template<typename Vector, typename KeyFunction>
+inline void radix_sort(Vector& v, KeyFunction key) {
+	detail::radix_sort_vector<false>(v, key);
+}
+
+// As above, but across threads
+template<typename Vector>
+inline void radix_sort(kane::parallel_t, Vector& v) {
+	detail::radix_identity_key key;
+	detail::radix_sort_vector<true>(v, key);
+}
+
+template<typename Vector, typename KeyFunction>
+inline void radix_sort(kane::parallel_t, Vector& v, KeyFunction key) {
+	detail::radix_sort_vector<true>(v, key);
+}
+
+}
@@ -20,9 +20,20 @@
 // trivial destructor and a trivial default constructor).  construct_range(i,j,v) should only be 
 // called when the range [i,j) contains only uninitialised elements (or when value_type has a 
 // trivial destructor).
+//
+// When value_type is trivially copyable (and the allocator doesn't insist on seeing every 
+// construct() call), copying and moving from ranges of raw pointers is done with a single 
+// memmove() instead of an element-by-element loop.  Other iterator types still use the loops.
+// Likewise, relocating elements (move-construct, then destroy the source) is a single memmove() 
+// when kane::is_trivially_relocatable<value_type> is true.  Filling a range with copies of a
+// value uses the vectorised kane::fast_fill_n() (see MemoryOps.h) when value_has_fast_fill, and
+// relocating a huge range into a new array streams it with kane::stream_copy(), or splits it 
+// across threads with kane::parallel_copy() if the value_type opts in with use_parallel_copy.
 #pragma once
 
 #include <KaneLib/Collections/ContainerFwd.h>
+#include <KaneLib/Algorithms/MemoryOps.h>
+#include <KaneLib/Algorithms/Parallel.h>
 
 namespace kane { namespace detail { 
 
@@ -56,11 +67,38 @@ namespace kane { namespace detail {
 		// value_type traits
 		static constexpr bool value_has_trivial_construct = std::is_trivially_constructible_v<value_type>;
 		static constexpr bool value_has_trivial_destroy = std::is_trivially_destructible_v<value_type>;
+		// True if elements can be copied and moved with memmove().  Needs a trivially copyable 
+		// value_type, raw pointers, and an allocator that doesn't customise construct() or destroy().
+		static constexpr bool value_has_trivial_copy = std::is_trivially_copyable_v<value_type> && 
+			std::is_pointer_v<pointer> && alloc_uses_default_construct_v<allocator_type, value_type>;
+		// True if a range of Iterator can be handed straight to memmove() in place of a copy or move
+		// loop: raw pointers to value_type, and move_iterators wrapping them.
+		template<typename Iterator>
+		static constexpr bool is_bulk_copy_source = value_has_trivial_copy && (
+			std::is_same_v<Iterator, pointer> || std::is_same_v<Iterator, const_pointer> ||
+			std::is_same_v<Iterator, std::move_iterator<pointer>> || std::is_same_v<Iterator, std::move_iterator<const_pointer>>);
+		// True if elements can be relocated with memmove().  Anything trivially copyable qualifies, 
+		// as does anything the user has declared trivially relocatable (given the same allocator 
+		// and pointer requirements as above).
+		static constexpr bool value_has_trivial_relocate = value_has_trivial_copy || (kane::is_trivially_relocatable<value_type>::value &&
+			std::is_pointer_v<pointer> && alloc_uses_default_construct_v<allocator_type, value_type>);
+		// True if huge bytewise copies should be split across threads.  A function rather than a 
+		// constant, because kane::use_parallel_copy is only defined once Vector.h is included, and 
+		// containers that never copy into new arrays shouldn't need it.
+		static constexpr bool value_has_parallel_copy() { return value_has_trivial_copy && kane::use_parallel_copy<value_type>::value; }
+		// True if ranges can be filled with copies of a value using kane::fast_fill_n()
+		static constexpr bool value_has_fast_fill = value_has_trivial_copy && kane::can_fast_fill<value_type>::value;
 		// allocator_type traits
 		static constexpr bool alloc_propagate_copy = typename allocator_type_traits::propagate_on_container_copy_assignment();
 		static constexpr bool alloc_propagate_move = typename allocator_type_traits::propagate_on_container_move_assignment();
 		static constexpr bool alloc_propagate_swap = typename allocator_type_traits::propagate_on_container_swap();
 		static constexpr bool alloc_is_always_equal = typename allocator_type_traits::is_always_equal();
+		// Optional allocator extensions (see ContainerFwd.h)
+		static constexpr bool alloc_can_expand = alloc_has_try_expand<allocator_type>::value;
+		static constexpr bool alloc_can_expand_zeroed = alloc_has_try_expand_zeroed<allocator_type>::value;
+		static constexpr bool alloc_can_reallocate = alloc_has_reallocate<allocator_type>::value;
+		static constexpr bool alloc_can_allocate_at_least = alloc_has_allocate_at_least<allocator_type>::value;
+		static constexpr bool alloc_can_allocate_zeroed = alloc_has_allocate_zeroed<allocator_type>::value;
 		
 		///////////////////////////////////////////////////////////////////////////////////////////
 		// Constructors
@@ -106,16 +144,73 @@ namespace kane { namespace detail {
 		// Return a new array of the specified capacity
 		pointer allocate(const size_type sz) { return allocator_type_traits::allocate(m_allocator(), sz); }
 		pointer allocate(const size_type sz, pointer const p) { return allocator_type_traits::allocate(m_allocator(), sz, p); }
+		// Return a new array of at least the specified capacity, and its actual capacity.  Allocators 
+		// without allocate_at_least() just get asked for exactly sz.
+		kane::allocation_result<pointer, size_type> allocate_at_least(const size_type sz) {
+			if constexpr(alloc_can_allocate_at_least) {
+				const auto result = m_allocator().allocate_at_least(sz);
+				return { result.ptr, size_type(result.count) };
+			} else {
+				return { allocate(sz), sz };
+			}
+		}
+		// Like allocate_at_least(), but the first sz elements are zero bytes.  Allocators without
+		// allocate_zeroed() get them zeroed by hand.  Only valid when value_has_trivial_copy.
+		kane::allocation_result<pointer, size_type> allocate_zeroed(const size_type sz) {
+			if constexpr(alloc_can_allocate_zeroed) {
+				const auto result = m_allocator().allocate_zeroed(sz);
+				return { result.ptr, size_type(result.count) };
+			} else {
+				const auto block = allocate_at_least(sz);
+				std::memset(block.ptr, 0, sz * sizeof(value_type));
+				return block;
+			}
+		}
 		// Deallocates the specified array allocated by our allocator
 		void deallocate(pointer const p, const size_type sz) { allocator_type_traits::deallocate(m_allocator(), p, sz); }
 		// Deallocate, getting the capacity from beginning and end pointers
 		void deallocate(pointer const p, pointer const c) { deallocate(p, c - p); }
+		// Try to grow the array in place.  Always fails if the allocator doesn't support it.
+		bool try_expand(pointer const p, const size_type oldSz, const size_type newSz) { 
+			if constexpr(alloc_can_expand) { return m_allocator().try_expand(p, oldSz, newSz); } 
+			else { return false; }
+		}
+		// Try to grow the array in place, with the new elements' bytes zeroed.  Always fails if the
+		// allocator doesn't support it.
+		bool try_expand_zeroed(pointer const p, const size_type oldSz, const size_type newSz) { 
+			if constexpr(alloc_can_expand_zeroed) { return m_allocator().try_expand_zeroed(p, oldSz, newSz); } 
+			else { return false; }
+		}
+		// Resize the array, moving its bytes if necessary.  Only available if alloc_can_reallocate.
+		pointer reallocate_array(pointer const p, const size_type oldSz, const size_type newSz) { 
+			return m_allocator().reallocate(p, oldSz, newSz); 
+		}
 		// Construct single element
 		template<typename... Args> 
 		void construct(pointer const p, Args&&... args) { allocator_type_traits::construct(m_allocator(), p, std::forward<Args>(args)...); }
 		// Destroy an element
 		void destroy(pointer const p) { allocator_type_traits::destroy(m_allocator(), p); }
 
+		///////////////////////////////////////////////////////////////////////////////////////////
+		// Bulk Copy Helpers
+		///////////////////////////////////////////////////////////////////////////////////////////
+		// Only valid when value_has_trivial_copy (or, when relocating, value_has_trivial_relocate).
+		// Elements are treated as raw bytes, so the ranges may overlap, and for trivially copyable
+		// types it doesn't matter whether the destination is initialised or not.
+
+		// Unwrap a bulk copy source into a plain pointer
+		static const_pointer bulk_source(const_pointer const i) { return i; }
+		static const_pointer bulk_source(const std::move_iterator<pointer>& i) { return i.base(); }
+		static const_pointer bulk_source(const std::move_iterator<const_pointer>& i) { return i.base(); }
+
+		// Copy count elements from src to dest.  Returns dest + count.
+		static pointer bulk_copy_n(pointer const dest, const_pointer const src, const size_type count) {
+			// memmove() is undefined for NULL pointers even when the count is zero, and an empty 
+			// vector has a NULL m_data, so this test is required.
+			if(count != 0) { std::memmove(dest, src, count * sizeof(value_type)); }
+			return dest + count;
+		}
+
 		///////////////////////////////////////////////////////////////////////////////////////////
 		// Range Helpers
 		///////////////////////////////////////////////////////////////////////////////////////////
@@ -154,8 +249,12 @@ namespace kane { namespace detail {
 
 		// Copy-constructs range to an exemplar element.  Returns last.
 		pointer construct_range(pointer first, pointer const last, const_reference val) {
-			while(first != last) { construct(first, val); ++first; }
-			return last;
+			if constexpr(value_has_fast_fill) {
+				return kane::fast_fill_n(first, size_type(last - first), val);
+			} else {
+				while(first != last) { construct(first, val); ++first; }
+				return last;
+			}
 		}
 
 		// Default-constructs n elements.  Returns pointer to one past the last constructed.
@@ -171,8 +270,12 @@ namespace kane { namespace detail {
 		// Copy-constructs n elements to an exemplar element.  Returns pointer to one past the last
 		// constructed.
 		pointer construct_n(pointer first, size_type n, const_reference val) {
-			while(n != 0) { construct(first, val); ++first; --n; }
-			return first;
+			if constexpr(value_has_fast_fill) {
+				return kane::fast_fill_n(first, n, val);
+			} else {
+				while(n != 0) { construct(first, val); ++first; --n; }
+				return first;
+			}
 		}
 
 		///////////////////////////////////
@@ -183,8 +286,12 @@ namespace kane { namespace detail {
 		// range.
 		template<typename InputIterator>
 		pointer copy_construct_from_range(pointer first1, InputIterator first2, InputIterator const last2) {
-			while(first2 != last2) { construct(first1, *first2); ++first1; ++first2; }
-			return first1;
+			if constexpr(is_bulk_copy_source<InputIterator>) {
+				return bulk_copy_n(first1, bulk_source(first2), size_type(last2 - first2));
+			} else {
+				while(first2 != last2) { construct(first1, *first2); ++first1; ++first2; }
+				return first1;
+			}
 		}
 
 		// Move-construct  a range of elements [first2, last2) into the memory beginning at first1.
@@ -192,24 +299,40 @@ namespace kane { namespace detail {
 		// range.
 		template<typename InputIterator>
 		pointer move_construct_from_range(pointer first1, InputIterator first2, InputIterator const last2) {
-			while(first2 != last2) { construct(first1, std::move(*first2)); ++first1; ++first2; }
-			return first1;
+			if constexpr(is_bulk_copy_source<InputIterator>) {
+				return bulk_copy_n(first1, bulk_source(first2), size_type(last2 - first2));
+			} else {
+				while(first2 != last2) { construct(first1, std::move(*first2)); ++first1; ++first2; }
+				return first1;
+			}
 		}
 
 		// Copy-construct a range of elements [first1, last1) from the range beginning with first2.  
 		// The source range is unchecked.  Returns iterator to the end of the source range.
 		template<typename InputIterator>
 		InputIterator copy_construct_range(pointer first1, pointer const last1, InputIterator first2) {
-			while(first1 != last1) { construct(first1, *first2); ++first1; ++first2; }
-			return first2;
+			if constexpr(is_bulk_copy_source<InputIterator>) {
+				const size_type count = size_type(last1 - first1);
+				bulk_copy_n(first1, bulk_source(first2), count);
+				return first2 + difference_type(count);
+			} else {
+				while(first1 != last1) { construct(first1, *first2); ++first1; ++first2; }
+				return first2;
+			}
 		}
 
 		// Move-construct a range of elements [first1, last1) from the range beginning with first2.  
 		// The source range is unchecked.  Returns iterator to the end of the source range.
 		template<typename InputIterator>
 		InputIterator move_construct_range(pointer first1, pointer const last1, InputIterator first2) {
-			while(first1 != last1) { construct(first1, std::move(*first2)); ++first1; ++first2; }
-			return first2;
+			if constexpr(is_bulk_copy_source<InputIterator>) {
+				const size_type count = size_type(last1 - first1);
+				bulk_copy_n(first1, bulk_source(first2), count);
+				return first2 + difference_type(count);
+			} else {
+				while(first1 != last1) { construct(first1, std::move(*first2)); ++first1; ++first2; }
+				return first2;
+			}
 		}
 		
 		// Copy the first N elements of the source range to the destination range.  Neither the
@@ -221,8 +344,12 @@ namespace kane { namespace detail {
 			// arithmetic operation, but it depends on compiler and CPU environment.  The CPU could easily 
 			// do the count decrement "on the side" using its branch-prediction machinery, since the count
 			// is exclusively a loop counter and not needed anywhere else, making it basically free.
-			while(count != 0) { construct(dest, *src); ++dest; ++src; --count; }
-			return std::make_pair(dest, src);
+			if constexpr(is_bulk_copy_source<InputIterator>) {
+				return std::make_pair(bulk_copy_n(dest, bulk_source(src), count), src + difference_type(count));
+			} else {
+				while(count != 0) { construct(dest, *src); ++dest; ++src; --count; }
+				return std::make_pair(dest, src);
+			}
 		}
 
 		// Move the first N elements of the source range to the destination range.  Neither the
@@ -230,8 +357,102 @@ namespace kane { namespace detail {
 		// Returns a tuple containing the ends of both ranges (dest+count, src+count).		
 		template<typename InputIterator>
 		std::pair<pointer, InputIterator> move_construct_range_n(pointer dest, InputIterator src, size_type count) {
-			while(count != 0) { construct(dest, std::move(*src)); ++dest; ++src; --count; }
-			return std::make_pair(dest, src);
+			if constexpr(is_bulk_copy_source<InputIterator>) {
+				return std::make_pair(bulk_copy_n(dest, bulk_source(src), count), src + difference_type(count));
+			} else {
+				while(count != 0) { construct(dest, std::move(*src)); ++dest; ++src; --count; }
+				return std::make_pair(dest, src);
+			}
+		}
+
+		///////////////////////////////////
+		// Range Relocation
+		
+		// Relocate the range [first, last) into the uninitialised memory beginning at dest: elements
+		// are move-constructed into the destination and the originals destroyed, leaving the source
+		// range uninitialised.  For trivially relocatable types this is a single memmove(), and the
+		// ranges may overlap; otherwise they must not.  Returns pointer to the end of the 
+		// destination range.
+		pointer relocate_from_range(pointer const dest, pointer const first, pointer const last) {
+			if constexpr(value_has_trivial_relocate) {
+				return bulk_copy_n(dest, first, size_type(last - first));
+			} else {
+				pointer const result = move_construct_from_range(dest, first, last);
+				destroy(first, last);
+				return result;
+			}
+		}
+
+		// Relocate the range [first, last) into a new array at dest, which mustn't overlap it.  Same
+		// as relocate_from_range(), except that bytewise relocations of at least 
+		// KANELIB_STREAMING_THRESHOLD bytes are streamed (see kane::stream_copy()), so reallocating
+		// a huge array doesn't flush the cache on the way, and really huge ones are split across 
+		// threads if the value_type opts in (see kane::use_parallel_copy).
+		pointer relocate_to_new_array(pointer const dest, pointer const first, pointer const last) {
+			if constexpr(value_has_trivial_relocate) {
+				const size_type count = size_type(last - first);
+				const std::size_t bytes = count * sizeof(value_type);
+				if(bytes >= KANELIB_PARALLEL_COPY_THRESHOLD && value_has_parallel_copy()) {
+					kane::parallel_copy(dest, first, bytes);
+					return dest + count;
+				} else if(bytes >= KANELIB_STREAMING_THRESHOLD) {
+					kane::stream_copy(dest, first, bytes);
+					return dest + count;
+				}
+			}
+			return relocate_from_range(dest, first, last);
+		}
+
+		// Copy-construct the range [first, last) into a new array at dest, which mustn't overlap it.
+		// Same as copy_construct_from_range(), except that really huge bytewise copies are split 
+		// across threads if the value_type opts in (see kane::use_parallel_copy).
+		pointer copy_to_new_array(pointer const dest, const_pointer const first, const_pointer const last) {
+			if constexpr(value_has_trivial_copy) {
+				const size_type count = size_type(last - first);
+				const std::size_t bytes = count * sizeof(value_type);
+				if(bytes >= KANELIB_PARALLEL_COPY_THRESHOLD && value_has_parallel_copy()) {
+					kane::parallel_copy(dest, first, bytes);
+					return dest + count;
+				}
+			}
+			return copy_construct_from_range(dest, first, last);
+		}
+
+		///////////////////////////////////
+		// Parallel Construction
+		// Like construct_n() and copy_construct_from_range(), but split into page-aligned slices on
+		// the parallel executor (see kane::parallel_for_pages()), so each worker thread is the first
+		// to touch its slice's pages.  Only done when constructing can't throw and the allocator 
+		// doesn't customise construct(); otherwise, everything is constructed on this thread.
+
+		// Copy-constructs n elements to an exemplar element.  Returns first + n.
+		pointer parallel_construct_n(pointer const first, const size_type n, const_reference val) {
+			if constexpr(std::is_nothrow_copy_constructible_v<value_type> && std::is_pointer_v<pointer> && 
+				alloc_uses_default_construct_v<allocator_type, value_type>) {
+				kane::parallel_for_pages(first, n, [&](const std::size_t begin, const std::size_t end) {
+					construct_n(first + begin, size_type(end - begin), val);
+				});
+				return first + n;
+			} else {
+				return construct_n(first, n, val);
+			}
+		}
+
+		// Copy-constructs the elements of [first2, last2) into the memory beginning at first1.  
+		// Returns pointer to the end of the destination range.
+		template<typename RandomAccessIterator>
+		pointer parallel_copy_construct_from_range(pointer const first1, RandomAccessIterator const first2, RandomAccessIterator const last2) {
+			typedef typename std::iterator_traits<RandomAccessIterator>::reference source_reference;
+			if constexpr(std::is_nothrow_constructible_v<value_type, source_reference> && std::is_pointer_v<pointer> && 
+				alloc_uses_default_construct_v<allocator_type, value_type>) {
+				const size_type n = size_type(last2 - first2);
+				kane::parallel_for_pages(first1, n, [&](const std::size_t begin, const std::size_t end) {
+					copy_construct_from_range(first1 + begin, first2 + difference_type(begin), first2 + difference_type(end));
+				});
+				return first1 + n;
+			} else {
+				return copy_construct_from_range(first1, first2, last2);
+			}
 		}
 
 		///////////////////////////////////
@@ -242,55 +463,65 @@ namespace kane { namespace detail {
 		// Copy-constructs a range of elements from an input range
 		template<typename InputIterator>
 		std::pair<pointer, InputIterator> checked_copy_construct_range(pointer first1, pointer const last1, InputIterator first2, InputIterator const last2) {
-			// TODO: Optimise this for InputIterators for which std::distance() is O(1)?
-			// TODO: Check if this works
-			if(std::is_same_v<std::random_access_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>) {
-				// If range 2 is smaller than range 1, adjust range1 to be the same size
-				const auto dist1 = std::distance(first1, last1);
-				const auto dist2 = std::distance(first2, last2);
-				if(dist2 < dist1) { last1 = first1 + dist2; }
-				while(first1 != last1) {
-					construct(first1, *first2);
-					++first1;
-					++first2;
-				}
-
+			if constexpr(is_bulk_copy_source<InputIterator>) {
+				const size_type count = std::min(size_type(last1 - first1), size_type(last2 - first2));
+				return std::make_pair(bulk_copy_n(first1, bulk_source(first2), count), first2 + difference_type(count));
 			} else {
-				while(first1 != last1 && first2 != last2) {
-					construct(first1, *first2);
-					++first1;
-					++first2;
+				// TODO: Optimise this for InputIterators for which std::distance() is O(1)?
+				// TODO: Check if this works
+				if(std::is_same_v<std::random_access_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>) {
+					// If range 2 is smaller than range 1, adjust range1 to be the same size
+					const auto dist1 = std::distance(first1, last1);
+					const auto dist2 = std::distance(first2, last2);
+					if(dist2 < dist1) { last1 = first1 + dist2; }
+					while(first1 != last1) {
+						construct(first1, *first2);
+						++first1;
+						++first2;
+					}
+
+				} else {
+					while(first1 != last1 && first2 != last2) {
+						construct(first1, *first2);
+						++first1;
+						++first2;
+					}
 				}
-			}
 
-			return std::make_pair(first1, first2);
+				return std::make_pair(first1, first2);
+			}
 		}
 
 		// Move-constructs a range of elements from an input range
 		template<typename InputIterator>
 		std::pair<pointer, InputIterator> checked_move_construct_range(pointer first1, pointer const last1, InputIterator first2, InputIterator const last2) {
-			// TODO: Optimise this for InputIterators for which std::distance() is O(1)?
-			// TODO: Check if this works
-			if(std::is_same_v<std::random_access_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>) {
-				// If range 2 is smaller than range 1, adjust range1 to be the same size
-				const auto dist1 = std::distance(first1, last1);
-				const auto dist2 = std::distance(first2, last2);
-				if(dist2 < dist1) { last1 = first1 + dist2; }
-				while(first1 != last1) {
-					construct(first1, std::move(*first2));
-					++first1;
-					++first2;
-				}
-
+			if constexpr(is_bulk_copy_source<InputIterator>) {
+				const size_type count = std::min(size_type(last1 - first1), size_type(last2 - first2));
+				return std::make_pair(bulk_copy_n(first1, bulk_source(first2), count), first2 + difference_type(count));
 			} else {
-				while(first1 != last1 && first2 != last2) {
-					construct(first1, std::move(*first2));
-					++first1;
-					++first2;
+				// TODO: Optimise this for InputIterators for which std::distance() is O(1)?
+				// TODO: Check if this works
+				if(std::is_same_v<std::random_access_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>) {
+					// If range 2 is smaller than range 1, adjust range1 to be the same size
+					const auto dist1 = std::distance(first1, last1);
+					const auto dist2 = std::distance(first2, last2);
+					if(dist2 < dist1) { last1 = first1 + dist2; }
+					while(first1 != last1) {
+						construct(first1, std::move(*first2));
+						++first1;
+						++first2;
+					}
+
+				} else {
+					while(first1 != last1 && first2 != last2) {
+						construct(first1, std::move(*first2));
+						++first1;
+						++first2;
+					}
 				}
-			}
 
-			return std::make_pair(first1, first2);
+				return std::make_pair(first1, first2);
+			}
 		}
 
 		///////////////////////////////////////////////////////
@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                   //////// kane::concurrent_vector<T,Alloc> ////////               ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// An append-only array that any number of threads can push into at once, without locks.
+//
+// Elements live in segments whose sizes double: segment 0 holds the first first_segment_size
+// elements, segment 1 the next 2 * first_segment_size, and so on.  Segments are never moved or
+// freed until the container is cleared or destroyed, so references to elements stay valid while
+// other threads keep appending.  Finding an element's segment is a single bit scan on its index
+// (see bit_scan_reverse() in Bits.h), so indexing is O(1).
+//
+// Appending claims indices by bumping an atomic size, and then constructs the elements in place.
+// The first thread to need a segment allocates it and publishes it with a compare-and-swap; if
+// two threads race, the loser frees its copy.
+//
+// Because size() counts claimed indices, it can include elements that are still being constructed
+// by another thread.  Only read elements you know are finished: those whose indices were returned
+// to the reading thread, or everything once the writers have been joined.
+//
+// Element constructors must not throw.  An index, once claimed, can't be handed back, so a failed
+// construction would leave a hole that the destructor would later destroy; instead, appending is
+// noexcept, and an exception (including failing to allocate a segment) terminates the program.
+//
+// Thread-safe: push_back(), emplace_back(), grow_by(), size(), empty(), element access
+// Not thread-safe: clear(), to_vector(), destruction
+//
+// The allocator must be safe to call from several threads at once, as std::allocator is.
+#pragma once
+
+#include <KaneLib/Collections/ContainerFwd.h>
+#include <KaneLib/Collections/ArrayContainerBase.h>
+#include <KaneLib/Collections/Vector.h>
+#include <KaneLib/Utility/Bits.h>
+
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+
+namespace kane {
+
+template<typename T, typename Alloc = std::allocator<T>>
+class concurrent_vector : protected detail::array_container_base<T, Alloc> {
+private:
+	typedef detail::array_container_base<T, Alloc> my_base;
+	typedef concurrent_vector<T, Alloc> my_type;
+
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef typename my_base::allocator_type	allocator_type;
+	typedef typename my_base::value_type		value_type;
+	typedef typename my_base::reference			reference;
+	typedef typename my_base::rvalue_reference	rvalue_reference;
+	typedef typename my_base::const_reference	const_reference;
+	typedef typename my_base::pointer			pointer;
+	typedef typename my_base::size_type			size_type;
+
+	// Segment layout
+	static constexpr unsigned first_segment_bits = 4;
+	static constexpr size_type first_segment_size = size_type(1) << first_segment_bits;
+	static constexpr unsigned segment_count = unsigned(sizeof(size_type) * 8) - first_segment_bits;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	concurrent_vector() noexcept(std::is_nothrow_default_constructible<Alloc>::value);
+	explicit concurrent_vector(const Alloc& allocator) noexcept;
+	// Shared between threads, so neither copyable nor movable.  Use to_vector() to take a copy.
+	concurrent_vector(const concurrent_vector&) = delete;
+	concurrent_vector& operator=(const concurrent_vector&) = delete;
+	~concurrent_vector();
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Information
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Number of claimed elements, including any still being constructed
+	size_type size() const noexcept { return m_size.load(std::memory_order_acquire); }
+	bool empty() const noexcept { return size() == 0; }
+	size_type max_size() const noexcept { return std::numeric_limits<size_type>::max() - first_segment_size + 1; }
+	allocator_type get_allocator() const noexcept { return this->m_allocator(); }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Appending
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Each returns the index of the (first) new element.
+	size_type push_back(const_reference val) noexcept { return emplace_back(val); }
+	size_type push_back(rvalue_reference rval) noexcept { return emplace_back(std::move(rval)); }
+	template<typename... Args>
+	size_type emplace_back(Args&&... args) noexcept;
+	// Append count default-constructed elements (left uninitialised for trivial types, as with
+	// kane::vector), or count copies of val
+	size_type grow_by(size_type count) noexcept;
+	size_type grow_by(size_type count, const_reference val) noexcept;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Element access
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	reference operator[](const size_type index) noexcept { return *slot(index); }
+	const_reference operator[](const size_type index) const noexcept { return *slot(index); }
+	reference at(size_type index);
+	const_reference at(size_type index) const;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Whole-container operations (not thread-safe)
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Copy the elements into a contiguous vector, one bulk copy per segment
+	kane::vector<T, Alloc> to_vector() const;
+	// Destroy every element, but keep the segments for reuse
+	void clear() noexcept;
+
+private:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Segment helpers
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Segment holding the given index
+	static KFINLINE unsigned segment_of(const size_type index) noexcept {
+		return kane::bit_scan_reverse(index + first_segment_size) - first_segment_bits;
+	}
+	// Index of a segment's first element
+	static KFINLINE size_type segment_base(const unsigned segment) noexcept { return (first_segment_size << segment) - first_segment_size; }
+	static KFINLINE size_type segment_size(const unsigned segment) noexcept { return first_segment_size << segment; }
+
+	// Address of the element at index, whose segment must exist
+	pointer slot(size_type index) const noexcept;
+	// Make sure the segments holding [first, last) exist
+	void ensure_segments(size_type first, size_type last);
+	// Call fn(pointer, count) for each contiguous run of [first, last)
+	template<typename Function>
+	void for_each_run(size_type first, size_type last, Function&& fn) const;
+
+	std::atomic<pointer> m_segments[segment_count];
+	// On its own line, because every appending thread hammers it
+	alignas(KANELIB_CACHE_LINE_SIZE) std::atomic<size_type> m_size;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+inline concurrent_vector<T,Alloc>::concurrent_vector() noexcept(std::is_nothrow_default_constructible<Alloc>::value)
+	: my_base(), m_size(0) {
+	for(unsigned i = 0; i != segment_count; ++i) { m_segments[i].store(NULL, std::memory_order_relaxed); }
+}
+
+template<typename T, typename Alloc>
+inline concurrent_vector<T,Alloc>::concurrent_vector(const Alloc& a) noexcept
+	: my_base(a), m_size(0) {
+	for(unsigned i = 0; i != segment_count; ++i) { m_segments[i].store(NULL, std::memory_order_relaxed); }
+}
+
+template<typename T, typename Alloc>
+inline concurrent_vector<T,Alloc>::~concurrent_vector() {
+	clear();
+	for(unsigned i = 0; i != segment_count; ++i) {
+		pointer const segment = m_segments[i].load(std::memory_order_relaxed);
+		if(segment) { this->deallocate(segment, segment_size(i)); }
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Appending
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+template<typename... Args>
+inline typename concurrent_vector<T,Alloc>::size_type concurrent_vector<T,Alloc>::emplace_back(Args&&... args) noexcept {
+	const size_type index = m_size.fetch_add(1, std::memory_order_relaxed);
+	ensure_segments(index, index + 1);
+	this->construct(slot(index), std::forward<Args>(args)...);
+	return index;
+}
+
+template<typename T, typename Alloc>
+inline typename concurrent_vector<T,Alloc>::size_type concurrent_vector<T,Alloc>::grow_by(const size_type count) noexcept {
+	const size_type first = m_size.fetch_add(count, std::memory_order_relaxed);
+	ensure_segments(first, first + count);
+	for_each_run(first, first + count, [this](pointer const p, const size_type n) { this->construct_n(p, n); });
+	return first;
+}
+
+template<typename T, typename Alloc>
+inline typename concurrent_vector<T,Alloc>::size_type concurrent_vector<T,Alloc>::grow_by(const size_type count, const_reference val) noexcept {
+	const size_type first = m_size.fetch_add(count, std::memory_order_relaxed);
+	ensure_segments(first, first + count);
+	for_each_run(first, first + count, [this, &val](pointer const p, const size_type n) { this->construct_n(p, n, val); });
+	return first;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+inline typename concurrent_vector<T,Alloc>::reference concurrent_vector<T,Alloc>::at(const size_type index) {
+	if(index >= size()) { throw std::out_of_range("kane::concurrent_vector::at() index out of range"); }
+	return *slot(index);
+}
+
+template<typename T, typename Alloc>
+inline typename concurrent_vector<T,Alloc>::const_reference concurrent_vector<T,Alloc>::at(const size_type index) const {
+	if(index >= size()) { throw std::out_of_range("kane::concurrent_vector::at() index out of range"); }
+	return *slot(index);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Whole-container operations
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+inline kane::vector<T, Alloc> concurrent_vector<T,Alloc>::to_vector() const {
+	const size_type count = size();
+	kane::vector<T, Alloc> result(kane::capacity(count), Alloc(this->m_allocator()));
+	for_each_run(0, count, [&result](pointer const p, const size_type n) { result.insert(result.end(), p, p + n); });
+	return result;
+}
+
+template<typename T, typename Alloc>
+inline void concurrent_vector<T,Alloc>::clear() noexcept {
+	for_each_run(0, m_size.load(std::memory_order_relaxed), [this](pointer const p, const size_type n) { this->destroy(p, p + n); });
+	m_size.store(0, std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Segment helpers
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+KFINLINE typename concurrent_vector<T,Alloc>::pointer concurrent_vector<T,Alloc>::slot(const size_type index) const noexcept {
+	const unsigned segment = segment_of(index);
+	return m_segments[segment].load(std::memory_order_acquire) + (index - segment_base(segment));
+}
+
+template<typename T, typename Alloc>
+inline void concurrent_vector<T,Alloc>::ensure_segments(const size_type first, const size_type last) {
+	if(first == last) { return; }
+	const unsigned lastSegment = segment_of(last - 1);
+	for(unsigned segment = segment_of(first); segment <= lastSegment; ++segment) {
+		if(m_segments[segment].load(std::memory_order_acquire)) { continue; }
+
+		// Publish a new segment, unless someone beats us to it
+		pointer const fresh = this->allocate(segment_size(segment));
+		pointer expected = NULL;
+		if(!m_segments[segment].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			this->deallocate(fresh, segment_size(segment));
+		}
+	}
+}
+
+template<typename T, typename Alloc>
+template<typename Function>
+inline void concurrent_vector<T,Alloc>::for_each_run(size_type first, const size_type last, Function&& fn) const {
+	while(first != last) {
+		const unsigned segment = segment_of(first);
+		const size_type runEnd = std::min(last, segment_base(segment) + segment_size(segment));
+		fn(slot(first), runEnd - first);
+		first = runEnd;
+	}
+}
+
+}
@@ -13,12 +13,28 @@
 #include <iostream>
 #include <type_traits>
 #include <tuple>
+#include <cstring>
+#include <charconv>
+#include <limits>
+#include <string_view>
+#include <system_error>
 
 // KaneLib utility includes
 #include <KaneLib/Algorithms/Algorithms.h>
 #include <KaneLib/Utility/Utility.h>
 #include <KaneLib/Utility/Iterator.h>
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace kane {
+
+// Trivial relocation and parallel copy traits, defined with the other element traits in Vector.h
+template<typename T> struct is_trivially_relocatable;
+template<typename T> struct use_parallel_copy;
+
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // alloc_container
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -99,4 +115,127 @@ protected:
 	KFINLINE Alloc& m_allocator()			  { return *this; }
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// inline_buffer
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Uninitialised, suitably aligned storage for N objects of type T, for containers that keep some 
+// or all of their elements inside the container object itself.  Like alloc_container, this does 
+// nothing but hold the storage.  It's meant to be the first base class of the container, so that 
+// it's constructed before (and destroyed after) the base classes that need its address.
+template<typename T, std::size_t N>
+class inline_buffer {
+	static_assert(N > 0, "inline_buffer needs room for at least one element");
+
+protected:
+	KFINLINE inline_buffer() { }
+	// Copying the storage would be meaningless; the container copies its elements itself
+	KFINLINE inline_buffer(const inline_buffer&) { }
+	KFINLINE inline_buffer& operator=(const inline_buffer&) { return *this; }
+
+	KFINLINE T* buffer_data()			  { return reinterpret_cast<T*>(m_buffer); }
+	KFINLINE const T* buffer_data() const { return reinterpret_cast<const T*>(m_buffer); }
+
+private:
+	alignas(T) unsigned char m_buffer[sizeof(T) * N];
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// alloc_uses_default_construct
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// True if allocator_traits<Alloc>::construct() and destroy() will fall back on placement new and 
+// calling the destructor directly, because Alloc doesn't provide its own construct() or destroy().
+// When this is the case, containers are free to skip the allocator entirely and create elements 
+// however they like--most importantly, with memcpy() and memmove() for trivially copyable types.
+// std::allocator is special-cased, because in C++17 it still has the (deprecated) construct() and
+// destroy() members, even though they don't do anything interesting.
+template<typename Alloc, typename T, typename Nope = void> 
+struct alloc_has_construct : public std::false_type { };
+template<typename Alloc, typename T> 
+struct alloc_has_construct<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().construct(std::declval<T*>(), std::declval<const T&>()))>> : public std::true_type { };
+
+template<typename Alloc, typename T, typename Nope = void> 
+struct alloc_has_destroy : public std::false_type { };
+template<typename Alloc, typename T> 
+struct alloc_has_destroy<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().destroy(std::declval<T*>()))>> : public std::true_type { };
+
+template<typename Alloc, typename T>
+using alloc_uses_default_construct = std::disjunction<
+	std::is_same<Alloc, std::allocator<T>>,
+	std::conjunction<std::negation<alloc_has_construct<Alloc, T>>, std::negation<alloc_has_destroy<Alloc, T>>>
+>;
+template<typename Alloc, typename T>
+constexpr bool alloc_uses_default_construct_v = alloc_uses_default_construct<Alloc, T>::value;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Allocator extensions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Allocators may optionally provide the following members, which array containers will detect and
+// use when growing their storage:
+//
+//   bool try_expand(pointer p, size_type oldCount, size_type newCount)
+//     Attempts to grow (or shrink) the block at p (allocated for oldCount elements) to hold 
+//     newCount elements without moving it.  Returns true on success, after which the block is 
+//     deallocated with newCount.  On failure, the block is left untouched.  Nothing is moved, so 
+//     this is used for any value_type.
+//
+//   bool try_expand_zeroed(pointer p, size_type oldCount, size_type newCount)
+//     Like try_expand(), but only for growing, and on success the bytes of elements oldCount to 
+//     newCount are all zero.  Allocators that grow blocks by committing fresh pages from the OS 
+//     should provide this, so containers growing into zero-filled elements (see kane::zeroed) 
+//     don't write to the new pages.
+//
+//   pointer reallocate(pointer p, size_type oldCount, size_type newCount)
+//     Resizes the block at p to newCount elements, copying its bytes to a new block if necessary, 
+//     like realloc().  Because elements may be moved bytewise, this is only used for trivially 
+//     relocatable value_types.  Throws on failure, in which case the old block is untouched.
+//
+//   allocation_result allocate_at_least(size_type n)
+//     Like C++23's allocate_at_least(): allocates room for at least n elements, and returns the 
+//     array along with the number of elements it can actually hold (as a kane::allocation_result
+//     or anything else with ptr and count members).  The block is later deallocated with that 
+//     count.  Containers use this to claim the slack malloc and friends leave at the end of a 
+//     block as capacity.
+//
+//   allocation_result allocate_zeroed(size_type n)
+//     Like allocate_at_least(), but the first n elements' bytes are all zero.  Allocators whose 
+//     memory comes zeroed anyway (calloc(), fresh anonymous mappings) should provide this, so 
+//     containers asked for zero-filled elements (see kane::zeroed) don't need to write to every 
+//     page, and untouched pages stay as the OS's shared zero page until they're written.  Without
+//     it, containers zero the elements themselves.
+template<typename Alloc, typename Nope = void>
+struct alloc_has_try_expand : public std::false_type { };
+template<typename Alloc>
+struct alloc_has_try_expand<Alloc, std::void_t<decltype(std::declval<Alloc&>().try_expand(
+	std::declval<typename std::allocator_traits<Alloc>::pointer>(), 
+	std::declval<typename std::allocator_traits<Alloc>::size_type>(), 
+	std::declval<typename std::allocator_traits<Alloc>::size_type>()))>> : public std::true_type { };
+
+template<typename Alloc, typename Nope = void>
+struct alloc_has_try_expand_zeroed : public std::false_type { };
+template<typename Alloc>
+struct alloc_has_try_expand_zeroed<Alloc, std::void_t<decltype(std::declval<Alloc&>().try_expand_zeroed(
+	std::declval<typename std::allocator_traits<Alloc>::pointer>(), 
+	std::declval<typename std::allocator_traits<Alloc>::size_type>(), 
+	std::declval<typename std::allocator_traits<Alloc>::size_type>()))>> : public std::true_type { };
+
+template<typename Alloc, typename Nope = void>
+struct alloc_has_reallocate : public std::false_type { };
+template<typename Alloc>
+struct alloc_has_reallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+	std::declval<typename std::allocator_traits<Alloc>::pointer>(), 
+	std::declval<typename std::allocator_traits<Alloc>::size_type>(), 
+	std::declval<typename std::allocator_traits<Alloc>::size_type>()))>> : public std::true_type { };
+
+template<typename Alloc, typename Nope = void>
+struct alloc_has_allocate_at_least : public std::false_type { };
+template<typename Alloc>
+struct alloc_has_allocate_at_least<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_at_least(
+	std::declval<typename std::allocator_traits<Alloc>::size_type>()).count)>> : public std::true_type { };
+
+template<typename Alloc, typename Nope = void>
+struct alloc_has_allocate_zeroed : public std::false_type { };
+template<typename Alloc>
+struct alloc_has_allocate_zeroed<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_zeroed(
+	std::declval<typename std::allocator_traits<Alloc>::size_type>()).count)>> : public std::true_type { };
+
 } }
\ No newline at end of file
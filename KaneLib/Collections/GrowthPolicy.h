@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                           //////// Growth Policies ////////                        ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Growth policies decide how much a vector's capacity grows by when it needs to reallocate.  The
+// classic answer is to double it, which is what kane::vector has always done, but that wastes up
+// to half the memory of a large buffer, while a smaller factor means more reallocations (and more
+// copying).  Which is better depends entirely on the use, so it's selectable per container type
+// by specialising kane::vector_growth_policy (below).
+//
+// A growth policy is a type providing two static constexpr functions:
+//   std::size_t next_capacity(std::size_t capacity, std::size_t elementSize)
+//     The capacity to grow to from the current capacity when the container is full.  Must be
+//     greater than capacity.
+//   std::size_t round_capacity(std::size_t needed, std::size_t elementSize)
+//     Rounds a capacity that's needed for some operation (like inserting a range) up to one the
+//     policy prefers.  Must be at least needed.
+// Both take the element size, so policies can reason about the size of the allocation in bytes.
+#pragma once
+
+#include <KaneLib/Config.h>
+
+#include <cstddef>
+
+namespace kane {
+
+///////////////////////////////////////
+// growth_factor_2
+///////////////////////////////////////
+// Double the capacity, starting at 2.  The default.
+struct growth_factor_2 {
+	static constexpr std::size_t next_capacity(const std::size_t capacity, std::size_t) {
+		// Huh, compiler implements this as "add eax,eax."  Surprising that add reg,reg is faster than
+		// shl reg/imm...
+		return capacity ? (capacity * 2) : 2;
+	}
+	static constexpr std::size_t round_capacity(const std::size_t needed, std::size_t) { return needed; }
+};
+
+///////////////////////////////////////
+// growth_factor_1_5
+///////////////////////////////////////
+// Grow the capacity by half, starting at 2.  (Roughly MSVC's resize factor.)  Wastes at most a
+// third of the allocation, at the cost of more reallocations.
+struct growth_factor_1_5 {
+	static constexpr std::size_t next_capacity(const std::size_t capacity, std::size_t) {
+		return capacity ? (capacity / 2 + capacity + 1) : 2;
+	}
+	static constexpr std::size_t round_capacity(const std::size_t needed, std::size_t) { return needed; }
+};
+
+///////////////////////////////////////
+// growth_page_rounded
+///////////////////////////////////////
+// Uses Base to pick capacities, then rounds any allocation of at least a page up to a whole number
+// of pages.  Large allocations come straight from the OS in pages anyway, so this just claims the
+// space that would otherwise be wasted at the end of the last page.  Smaller allocations are left
+// alone.
+template<std::size_t PageSize = 4096, typename Base = growth_factor_2>
+struct growth_page_rounded {
+	static_assert(PageSize != 0 && (PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+	static constexpr std::size_t next_capacity(const std::size_t capacity, const std::size_t elementSize) {
+		return round(Base::next_capacity(capacity, elementSize), elementSize);
+	}
+	static constexpr std::size_t round_capacity(const std::size_t needed, const std::size_t elementSize) {
+		return round(Base::round_capacity(needed, elementSize), elementSize);
+	}
+
+private:
+	static constexpr std::size_t round(const std::size_t count, const std::size_t elementSize) {
+		const std::size_t bytes = count * elementSize;
+		if(bytes < PageSize) { return count; }
+		// Any whole number of elements that fits in the rounded size is at least count
+		return ((bytes + PageSize - 1) & ~(PageSize - 1)) / elementSize;
+	}
+};
+
+///////////////////////////////////////
+// growth_size_class
+///////////////////////////////////////
+// Uses Base to pick capacities, then rounds the allocation up to the size class the allocator
+// would have used anyway.  The classes modelled here are jemalloc's (also close to tcmalloc's):
+// 16 bytes minimum, then four classes per power of two, so 16, 32, 48, 64, 80, 96, 112, 128, 160,
+// 192, 224, 256, 320, and so on.
+template<typename Base = growth_factor_2>
+struct growth_size_class {
+	static constexpr std::size_t next_capacity(const std::size_t capacity, const std::size_t elementSize) {
+		return round(Base::next_capacity(capacity, elementSize), elementSize);
+	}
+	static constexpr std::size_t round_capacity(const std::size_t needed, const std::size_t elementSize) {
+		return round(Base::round_capacity(needed, elementSize), elementSize);
+	}
+
+private:
+	static constexpr std::size_t floor_log2(std::size_t n) {
+		std::size_t result = 0;
+		while(n >>= 1) { ++result; }
+		return result;
+	}
+
+	static constexpr std::size_t size_class(const std::size_t bytes) {
+		if(bytes <= 16) { return 16; }
+		// Class spacing is a quarter of the power of two below the size, but never less than 16
+		const std::size_t lg = floor_log2(bytes - 1);
+		const std::size_t spacing = (lg < 6) ? 16 : (std::size_t(1) << (lg - 2));
+		return (bytes + spacing - 1) & ~(spacing - 1);
+	}
+
+	static constexpr std::size_t round(const std::size_t count, const std::size_t elementSize) {
+		return count ? size_class(count * elementSize) / elementSize : 0;
+	}
+};
+
+///////////////////////////////////////
+// vector_growth_policy type trait
+///////////////////////////////////////
+// Specialise this trait to select the growth policy for kane::vector<T,Alloc> (and the containers
+// built on vector_base).  For example, to grow all vectors of floats by 1.5x:
+//   template<typename Alloc> struct kane::vector_growth_policy<float, Alloc> { typedef kane::growth_factor_1_5 type; };
+template<typename T, typename Alloc> struct vector_growth_policy { typedef growth_factor_2 type; };
+
+}
@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                        //////// kane::mapped_vector<T> ////////                   ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A read-only view of a file written by kane::write_binary() (see VectorIO.h), memory-mapped
+// rather than read in.  Opening one only maps the file and checks its header, so it takes the
+// same time for a kilobyte as for ten gigabytes; the elements are paged in from the OS's file
+// cache the first time each page is touched.  Every process mapping the same file shares the same
+// physical pages, too.
+//
+//   kane::mapped_vector<entry> table("reference.bin");
+//   table.advise(kane::access_pattern::random);	// lookups; don't bother reading ahead
+//   lookup(table[i]);
+//
+// It provides the const half of kane::vector's interface: iterators (plain const pointers),
+// element access, data() and size().  The elements can't be modified: the mapping is read-only,
+// so writing through a const_cast crashes.
+//
+// Since the pages are read lazily, the payload's checksum isn't checked when the file is opened;
+// call verify() to check it (which reads the whole file).  The header is checked in full, and
+// opening throws binary_format_error if it doesn't match T or the file is too short for its
+// count, or std::ios_base::failure if the file can't be opened or mapped.
+//
+// The file shouldn't be modified while it's mapped: on POSIX platforms, the changes would show up
+// in the view, and truncating it would make touching the missing pages crash.  Replace it by
+// writing a new file and renaming it over the old one instead, which leaves existing mappings
+// looking at the old contents.
+//
+// Moveable but not copyable.  Thread-safe to read from any number of threads.
+#pragma once
+
+#include <KaneLib/Collections/ContainerFwd.h>
+#include <KaneLib/Collections/VectorIO.h>
+#include <KaneLib/Memory/VirtualMemory.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace kane {
+
+// How a mapped_vector is going to be read, so the OS can read ahead (or not) to suit
+enum class access_pattern {
+	normal,		// moderate read-ahead (the default)
+	sequential,	// aggressive read-ahead, and pages behind the reader can go early
+	random		// no read-ahead
+};
+
+template<typename T>
+class mapped_vector {
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef T										value_type;
+	typedef const T&								reference;
+	typedef const T&								const_reference;
+	typedef const T*								pointer;
+	typedef const T*								const_pointer;
+	typedef std::size_t								size_type;
+	typedef std::ptrdiff_t							difference_type;
+
+	typedef const_pointer							iterator;
+	typedef const_pointer							const_iterator;
+	typedef std::reverse_iterator<const_iterator>	reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>	const_reverse_iterator;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Construct an empty view, mapping nothing
+	mapped_vector() noexcept : m_mapping(NULL), m_mappedBytes(0), m_data(NULL), m_size(0), m_checksum(0) { }
+	// Map the file at path
+	explicit mapped_vector(const char* path);
+	explicit mapped_vector(const std::string& path) : mapped_vector(path.c_str()) { }
+	mapped_vector(mapped_vector&& other) noexcept;
+	mapped_vector& operator=(mapped_vector&& rhs) noexcept;
+	mapped_vector(const mapped_vector&) = delete;
+	mapped_vector& operator=(const mapped_vector&) = delete;
+	~mapped_vector() { detail::vm::unmap_file(m_mapping, m_mappedBytes); }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Iterators
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	const_iterator begin() const noexcept { return m_data; }
+	const_iterator end() const noexcept { return m_data + m_size; }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+	const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+	const_reverse_iterator crend() const noexcept { return rend(); }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Information
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	size_type size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+	// True if a file is mapped (even one with no elements)
+	bool is_open() const noexcept { return m_mapping != NULL; }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Element access
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	const_reference operator[](const size_type index) const noexcept { _ASSERTE(index < m_size); return m_data[index]; }
+	const_reference at(size_type index) const;
+	const_reference front() const noexcept { _ASSERTE(!empty()); return m_data[0]; }
+	const_reference back() const noexcept { _ASSERTE(!empty()); return m_data[m_size - 1]; }
+	const_pointer data() const noexcept { return m_data; }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Paging
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Tell the OS how the elements are going to be read (madvise() on POSIX platforms; does
+	// nothing on Windows)
+	void advise(access_pattern pattern) const noexcept;
+	// Start reading elements [first, last) in from the file in the background, so they're in
+	// memory by the time they're needed (MADV_WILLNEED, or PrefetchVirtualMemory() on Windows)
+	void prefetch(size_type first, size_type last) const noexcept;
+	void prefetch() const noexcept { prefetch(0, m_size); }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Verification
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// True if the elements match the checksum in the file's header.  Reads every page.
+	bool verify() const noexcept { return kane::binary_checksum(m_data, m_size * sizeof(T)) == m_checksum; }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Modifiers
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Unmap the file, leaving an empty view
+	void reset() noexcept { mapped_vector().swap(*this); }
+	void swap(mapped_vector& other) noexcept;
+
+private:
+	const void* m_mapping;
+	std::size_t m_mappedBytes;
+	const T* m_data;
+	size_type m_size;
+	std::uint64_t m_checksum;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+inline mapped_vector<T>::mapped_vector(const char* const path) : mapped_vector() {
+	// The elements start right after the header, which is all the alignment we can promise
+	static_assert(alignof(T) <= sizeof(binary_header), "kane::mapped_vector can't map over-aligned types");
+
+	m_mapping = detail::vm::map_file(path, m_mappedBytes);
+	if(!m_mapping) { throw std::ios_base::failure("kane::mapped_vector: can't open and map file"); }
+
+	// From here on, the destructor unmaps it if we throw
+	mapped_vector guard;
+	guard.swap(*this);
+
+	if(guard.m_mappedBytes < sizeof(binary_header)) { throw binary_format_error("kane::mapped_vector: not a kane binary vector"); }
+	binary_header header;
+	std::memcpy(&header, guard.m_mapping, sizeof(header));
+	const size_type count = detail::check_binary_header<T, size_type>(header);
+	if((guard.m_mappedBytes - sizeof(binary_header)) / sizeof(T) < count) { throw binary_format_error("kane::mapped_vector: file is truncated"); }
+
+	guard.m_data = reinterpret_cast<const T*>(static_cast<const unsigned char*>(guard.m_mapping) + sizeof(binary_header));
+	guard.m_size = count;
+	guard.m_checksum = header.checksum;
+	guard.swap(*this);
+}
+
+template<typename T>
+inline mapped_vector<T>::mapped_vector(mapped_vector&& other) noexcept : mapped_vector() { swap(other); }
+
+template<typename T>
+inline mapped_vector<T>& mapped_vector<T>::operator=(mapped_vector&& rhs) noexcept {
+	mapped_vector(std::move(rhs)).swap(*this);
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+inline typename mapped_vector<T>::const_reference mapped_vector<T>::at(const size_type index) const {
+	if(index >= m_size) { throw std::out_of_range("kane::mapped_vector::at() index out of range"); }
+	return m_data[index];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Paging
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+inline void mapped_vector<T>::advise(const access_pattern pattern) const noexcept {
+	static const detail::vm::advice advice[] = { detail::vm::advice::normal, detail::vm::advice::sequential, detail::vm::advice::random };
+	detail::vm::advise(m_mapping, m_mappedBytes, advice[int(pattern)]);
+}
+
+template<typename T>
+inline void mapped_vector<T>::prefetch(const size_type first, const size_type last) const noexcept {
+	_ASSERTE(first <= last && last <= m_size);
+	detail::vm::advise(m_data + first, (last - first) * sizeof(T), detail::vm::advice::will_need);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Modifiers
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+inline void mapped_vector<T>::swap(mapped_vector& other) noexcept {
+	std::swap(m_mapping, other.m_mapping);
+	std::swap(m_mappedBytes, other.m_mappedBytes);
+	std::swap(m_data, other.m_data);
+	std::swap(m_size, other.m_size);
+	std::swap(m_checksum, other.m_checksum);
+}
+
+template<typename T>
+inline void swap(mapped_vector<T>& lhs, mapped_vector<T>& rhs) noexcept { lhs.swap(rhs); }
+
+}
@@ -0,0 +1,24 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                        //////// kane::reserved_vector<T> ////////                  ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A kane::vector that reserves a large range of address space up front and commits pages as it
+// grows into them (see Memory/ReservedAllocator.h).  Growing never moves the elements, so
+//  - push_back(), emplace_back(), append and reserve() never copy anything, and never need the
+//    old and new arrays at once, and
+//  - pointers, references and iterators to the elements stay valid as the vector grows, right
+//    up until it runs out of reservation (which throws std::bad_alloc).
+// Inserting or erasing in the middle still shifts the elements after the position, as usual.
+//
+// Each vector's reservation is set by its allocator:
+//   kane::reserved_vector<float> v(kane::reserved_allocator<float>(std::size_t(1) << 40));
+#pragma once
+
+#include <KaneLib/Collections/Vector.h>
+#include <KaneLib/Memory/ReservedAllocator.h>
+
+namespace kane {
+
+template<typename T>
+using reserved_vector = vector<T, reserved_allocator<T>>;
+
+}
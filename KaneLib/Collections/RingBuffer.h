@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                       //////// kane::ring_buffer<T,Alloc> ////////                 ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A bounded, lock-free queue for exactly one producer thread and one consumer thread.
+//
+// The elements live in a single array whose capacity is rounded up to a power of two, so wrapping
+// an index is a mask rather than a division.  The head (next element to pop) and tail (next slot
+// to push into) indices are never wrapped themselves; they just count up forever, so the size is
+// always tail - head, even once they overflow, and a full buffer is distinguishable from an empty
+// one without wasting a slot.
+//
+// The head is only written by the consumer and the tail only by the producer, and each lives on
+// its own cache line alongside that thread's cached copy of the other index.  The cached copies
+// mean that each side only reads the other's index (and so only pulls its cache line across) when
+// the buffer looks full or empty from its point of view.
+//
+// push_n() and pop_n() transfer a batch with one index update, and copy in at most two contiguous
+// runs (either side of the wrap), using array_container_base's bulk helpers.  For trivially
+// copyable types copied from pointers, each run is a single memmove.
+//
+// Producer functions: try_push(), try_emplace(), push_n()
+// Consumer functions: try_pop(), pop_n()
+// Either thread: capacity(), size(), empty(), though size() and empty() are only a snapshot.
+#pragma once
+
+#include <KaneLib/Collections/ContainerFwd.h>
+#include <KaneLib/Collections/ArrayContainerBase.h>
+#include <KaneLib/Utility/Bits.h>
+
+#include <atomic>
+
+namespace kane {
+
+template<typename T, typename Alloc = std::allocator<T>>
+class ring_buffer : protected detail::array_container_base<T, Alloc> {
+private:
+	typedef detail::array_container_base<T, Alloc> my_base;
+	typedef ring_buffer<T, Alloc> my_type;
+
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef typename my_base::allocator_type	allocator_type;
+	typedef typename my_base::value_type		value_type;
+	typedef typename my_base::reference			reference;
+	typedef typename my_base::rvalue_reference	rvalue_reference;
+	typedef typename my_base::const_reference	const_reference;
+	typedef typename my_base::pointer			pointer;
+	typedef typename my_base::size_type			size_type;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Construct empty buffer holding at least minCapacity elements (rounded up to a power of two)
+	explicit ring_buffer(size_type minCapacity, const Alloc& allocator = Alloc());
+	// Shared between threads, so neither copyable nor movable
+	ring_buffer(const ring_buffer&) = delete;
+	ring_buffer& operator=(const ring_buffer&) = delete;
+	// Destroys any elements still in the buffer.  Neither thread may be using it.
+	~ring_buffer();
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Information
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	size_type capacity() const noexcept { return m_mask + 1; }
+	size_type size() const noexcept;
+	bool empty() const noexcept { return size() == 0; }
+	allocator_type get_allocator() const noexcept { return this->m_allocator(); }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Producer
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Push a single element.  Returns false (without touching val) if the buffer is full.
+	bool try_push(const_reference val) { return try_emplace(val); }
+	bool try_push(rvalue_reference rval) { return try_emplace(std::move(rval)); }
+	// Construct a single element in place.  Returns false if the buffer is full.
+	template<typename... Args>
+	bool try_emplace(Args&&... args);
+	// Push as many of the count elements starting at first as will fit, returning how many that
+	// was.  Pass move iterators to move the elements in.  If copying an element throws, the
+	// elements before it are still pushed.
+	template<typename ForwardIterator>
+	size_type push_n(ForwardIterator first, size_type count);
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Consumer
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Move the oldest element into out.  Returns false if the buffer is empty.
+	bool try_pop(reference out);
+	// Move up to count of the oldest elements into out, returning how many were popped.  If a
+	// move assignment throws, nothing is popped (though some elements may have been moved from).
+	template<typename OutputIterator>
+	size_type pop_n(OutputIterator out, size_type count);
+
+private:
+	// Read-only after construction, so can share a cache line with anything
+	pointer m_data;
+	size_type m_mask;
+
+	// Consumer's cache line
+	alignas(KANELIB_CACHE_LINE_SIZE) std::atomic<size_type> m_head;
+	size_type m_cachedTail;
+
+	// Producer's cache line.  (The class's alignment pads out the rest of the line.)
+	alignas(KANELIB_CACHE_LINE_SIZE) std::atomic<size_type> m_tail;
+	size_type m_cachedHead;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+inline ring_buffer<T,Alloc>::ring_buffer(const size_type minCapacity, const Alloc& a)
+	: my_base(a), m_data(NULL), m_mask(0), m_head(0), m_cachedTail(0), m_tail(0), m_cachedHead(0) {
+	const size_type newCapacity = kane::next_power_of_two(std::max(minCapacity, size_type(2)));
+	m_data = this->allocate(newCapacity);
+	m_mask = newCapacity - 1;
+}
+
+template<typename T, typename Alloc>
+inline ring_buffer<T,Alloc>::~ring_buffer() {
+	const size_type head = m_head.load(std::memory_order_relaxed);
+	const size_type count = m_tail.load(std::memory_order_relaxed) - head;
+
+	// Remaining elements may wrap around the end of the array
+	const size_type offset = head & m_mask;
+	const size_type firstCount = std::min(count, capacity() - offset);
+	this->destroy(m_data + offset, m_data + offset + firstCount);
+	this->destroy(m_data, m_data + (count - firstCount));
+
+	this->deallocate(m_data, capacity());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Information
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+inline typename ring_buffer<T,Alloc>::size_type ring_buffer<T,Alloc>::size() const noexcept {
+	// Head first, so the tail we read can't be behind it
+	const size_type head = m_head.load(std::memory_order_acquire);
+	return m_tail.load(std::memory_order_acquire) - head;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Producer
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+template<typename... Args>
+inline bool ring_buffer<T,Alloc>::try_emplace(Args&&... args) {
+	const size_type tail = m_tail.load(std::memory_order_relaxed);
+
+	// Only look at the real head if the buffer looks full
+	if(tail - m_cachedHead == capacity()) {
+		m_cachedHead = m_head.load(std::memory_order_acquire);
+		if(tail - m_cachedHead == capacity()) { return false; }
+	}
+
+	this->construct(m_data + (tail & m_mask), std::forward<Args>(args)...);
+	m_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T, typename Alloc>
+template<typename ForwardIterator>
+inline typename ring_buffer<T,Alloc>::size_type ring_buffer<T,Alloc>::push_n(ForwardIterator first, const size_type count) {
+	const size_type tail = m_tail.load(std::memory_order_relaxed);
+
+	// Only look at the real head if there doesn't seem to be enough room
+	size_type space = capacity() - (tail - m_cachedHead);
+	if(space < count) {
+		m_cachedHead = m_head.load(std::memory_order_acquire);
+		space = capacity() - (tail - m_cachedHead);
+	}
+
+	const size_type n = std::min(count, space);
+	if(n == 0) { return 0; }
+
+	typedef typename std::iterator_traits<ForwardIterator>::reference source_reference;
+	if constexpr(std::is_nothrow_constructible<value_type, source_reference>::value) {
+		// Copy in up to two runs, either side of the end of the array
+		const size_type offset = tail & m_mask;
+		const size_type firstCount = std::min(n, capacity() - offset);
+
+		const ForwardIterator mid = std::next(first, firstCount);
+		this->copy_construct_from_range(m_data + offset, first, mid);
+		if(firstCount != n) {
+			this->copy_construct_from_range(m_data, mid, std::next(mid, n - firstCount));
+		}
+
+	} else {
+		// One at a time, so that if a copy throws, we know what to publish
+		size_type pushed = 0;
+		try {
+			for(; pushed != n; ++pushed, ++first) {
+				this->construct(m_data + ((tail + pushed) & m_mask), *first);
+			}
+		} catch(...) {
+			m_tail.store(tail + pushed, std::memory_order_release);
+			throw;
+		}
+	}
+
+	m_tail.store(tail + n, std::memory_order_release);
+	return n;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Consumer
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+inline bool ring_buffer<T,Alloc>::try_pop(reference out) {
+	const size_type head = m_head.load(std::memory_order_relaxed);
+
+	// Only look at the real tail if the buffer looks empty
+	if(head == m_cachedTail) {
+		m_cachedTail = m_tail.load(std::memory_order_acquire);
+		if(head == m_cachedTail) { return false; }
+	}
+
+	pointer const p = m_data + (head & m_mask);
+	out = std::move(*p);
+	this->destroy(p);
+	m_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T, typename Alloc>
+template<typename OutputIterator>
+inline typename ring_buffer<T,Alloc>::size_type ring_buffer<T,Alloc>::pop_n(OutputIterator out, const size_type count) {
+	const size_type head = m_head.load(std::memory_order_relaxed);
+
+	// Only look at the real tail if there don't seem to be enough elements
+	size_type available = m_cachedTail - head;
+	if(available < count) {
+		m_cachedTail = m_tail.load(std::memory_order_acquire);
+		available = m_cachedTail - head;
+	}
+
+	const size_type n = std::min(count, available);
+	if(n == 0) { return 0; }
+
+	// Move out in up to two runs, either side of the end of the array, and only destroy anything
+	// once everything's been moved
+	const size_type offset = head & m_mask;
+	const size_type firstCount = std::min(n, capacity() - offset);
+	pointer const first = m_data + offset;
+
+	out = std::move(first, first + firstCount, out);
+	if(firstCount != n) { std::move(m_data, m_data + (n - firstCount), out); }
+
+	this->destroy(first, first + firstCount);
+	this->destroy(m_data, m_data + (n - firstCount));
+
+	m_head.store(head + n, std::memory_order_release);
+	return n;
+}
+
+}
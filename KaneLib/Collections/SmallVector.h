@@ -0,0 +1,368 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                    //////// kane::small_vector<T,N,Alloc> ////////                 ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A kane::vector with room for N elements inside the object itself.  Until it grows past N
+// elements, a small_vector never touches the heap; after that, it behaves exactly like a vector
+// using Alloc.
+//
+// Rather than reimplement the vector, small_vector *is* a vector, using a special allocator
+// (detail::small_vector_allocator) which hands out the inline buffer when it's asked for N or
+// fewer elements and the buffer isn't already in use, and otherwise defers to Alloc.  Everything
+// in Vector.inl (insert, replace, take, the bulk copy paths, and so on) works unchanged, and
+// reallocation naturally spills from the buffer to the heap.  The buffer is reported through
+// allocate_at_least(), so capacity() is N from the start.
+//
+// The allocator holds a pointer to the buffer, so it can't be copied, moved or swapped between
+// containers like an ordinary allocator.  small_vector provides its own copy, move and swap
+// operations which take care of this, adopting the other container's heap array when possible.
+// For the same reason, don't move or swap a small_vector through a reference to its vector base.
+// (Copying through the base is fine; the copy just won't have an inline buffer.)
+#pragma once
+
+#include <KaneLib/Collections/ContainerFwd.h>
+#include <KaneLib/Collections/Vector.h>
+
+namespace kane {
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// small_vector_allocator
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Allocator for small_vector.  Hands out the buffer for requests of up to N elements, as long as
+// it isn't already in use (it may be, while the vector reallocates), and forwards everything else
+// to the base allocator.  An allocator with a NULL buffer (like the one a vector copied from a
+// small_vector ends up with) always uses the base allocator.
+//
+// Two small_vector_allocators are only equal if they share a buffer, so the vector will never
+// hand its array to a different small_vector.  rebind is only there to keep allocator_traits 
+// happy; rebinding to anything but T gives an allocator that can't use the buffer.
+template<typename T, std::size_t N, typename Alloc>
+class small_vector_allocator {
+private:
+	typedef std::allocator_traits<Alloc> base_traits;
+	static_assert(std::is_pointer<typename base_traits::pointer>::value, "small_vector requires an allocator using raw pointers");
+
+public:
+	typedef T									  value_type;
+	typedef T*									  pointer;
+	typedef const T*							  const_pointer;
+	typedef typename base_traits::size_type		  size_type;
+	typedef typename base_traits::difference_type difference_type;
+
+	typedef std::false_type propagate_on_container_copy_assignment;
+	typedef std::false_type propagate_on_container_move_assignment;
+	typedef std::false_type propagate_on_container_swap;
+	typedef std::false_type is_always_equal;
+
+	template<typename U> struct rebind { typedef small_vector_allocator<U, N, typename base_traits::template rebind_alloc<U>> other; };
+
+	small_vector_allocator(T* const buffer, const Alloc& base)
+		: m_base(base), m_buffer(buffer), m_bufferUsed(buffer == NULL) { }
+
+	// A vector copied from a small_vector has no buffer of its own, so only gets the base allocator
+	small_vector_allocator select_on_container_copy_construction() const {
+		return small_vector_allocator(NULL, base_traits::select_on_container_copy_construction(m_base));
+	}
+
+	///////////////////////////////////
+	// Allocation
+	T* allocate(const size_type n) {
+		if(n <= N && !m_bufferUsed) {
+			m_bufferUsed = true;
+			return m_buffer;
+		}
+		return base_traits::allocate(m_base, n);
+	}
+
+	// The buffer always counts as N elements
+	kane::allocation_result<T*, size_type> allocate_at_least(const size_type n) {
+		if(n <= N && !m_bufferUsed) {
+			m_bufferUsed = true;
+			return { m_buffer, N };
+		}
+		if constexpr(alloc_has_allocate_at_least<Alloc>::value) {
+			const auto result = m_base.allocate_at_least(n);
+			return { result.ptr, size_type(result.count) };
+		} else {
+			return { base_traits::allocate(m_base, n), n };
+		}
+	}
+
+	void deallocate(T* const p, const size_type n) {
+		if(p == m_buffer) {
+			m_bufferUsed = false;
+		} else {
+			base_traits::deallocate(m_base, p, n);
+		}
+	}
+
+	size_type max_size() const { return base_traits::max_size(m_base); }
+
+	///////////////////////////////////
+	// Construction
+	// Only provided if the base allocator has its own construct() and destroy(), so trivially
+	// copyable types still get the memcpy paths when it doesn't.
+	template<typename U, typename... Args, typename B = Alloc, typename = std::enable_if_t<!alloc_uses_default_construct_v<B, T>>>
+	void construct(U* const p, Args&&... args) { base_traits::construct(m_base, p, std::forward<Args>(args)...); }
+	template<typename U, typename B = Alloc, typename = std::enable_if_t<!alloc_uses_default_construct_v<B, T>>>
+	void destroy(U* const p) { base_traits::destroy(m_base, p); }
+
+	///////////////////////////////////
+	// Access
+	const Alloc& base() const { return m_base; }
+	const T* buffer() const { return m_buffer; }
+
+	friend bool operator==(const small_vector_allocator& lhs, const small_vector_allocator& rhs) { return lhs.m_buffer == rhs.m_buffer; }
+	friend bool operator!=(const small_vector_allocator& lhs, const small_vector_allocator& rhs) { return lhs.m_buffer != rhs.m_buffer; }
+
+private:
+	Alloc m_base;
+	T* m_buffer;
+	bool m_bufferUsed;
+};
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// small_vector
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T, std::size_t N, typename Alloc = std::allocator<T>>
+class small_vector : private detail::inline_buffer<T, N>, public vector<T, detail::small_vector_allocator<T, N, Alloc>> {
+private:
+	typedef detail::inline_buffer<T, N>								buffer_base;
+	typedef vector<T, detail::small_vector_allocator<T, N, Alloc>>	my_base;
+	typedef small_vector<T, N, Alloc>								my_type;
+
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef typename my_base::allocator_type	allocator_type;
+	typedef Alloc								base_allocator_type;
+	typedef typename my_base::value_type		value_type;
+	typedef typename my_base::const_reference	const_reference;
+	typedef typename my_base::pointer			pointer;
+	typedef typename my_base::size_type			size_type;
+
+	// Number of elements that fit in the inline buffer
+	static constexpr size_type inline_capacity = N;
+
+	// Moves can only allocate if the heap arrays can't change hands
+	static constexpr bool nothrow_move = std::is_nothrow_move_constructible<T>::value && std::allocator_traits<Alloc>::is_always_equal::value;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Construct empty vector using the inline buffer
+	small_vector() noexcept(std::is_nothrow_default_constructible<Alloc>::value);
+	explicit small_vector(const Alloc& allocator) noexcept;
+	// Construct vector with initialSize default-constructed elements
+	explicit small_vector(size_type initialSize, const Alloc& allocator = Alloc());
+	// Construct vector with initialSize copies of given value
+	small_vector(size_type initialSize, const_reference val, const Alloc& allocator = Alloc());
+	// Construct vector containing elements in given iterator range
+	template<typename InputIterator, typename = enable_if_iterator_t<InputIterator>>
+	small_vector(InputIterator first, InputIterator last, const Alloc& allocator = Alloc());
+	// Initialiser list construction
+	small_vector(std::initializer_list<T> init, const Alloc& allocator = Alloc());
+	// Copy construct from another small_vector
+	small_vector(const small_vector& other);
+	// Move construct from another small_vector, taking its heap array if it has one
+	small_vector(small_vector&& other) noexcept(small_vector::nothrow_move);
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Assignment
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	small_vector& operator=(const small_vector& rhs);
+	small_vector& operator=(small_vector&& rhs) noexcept(small_vector::nothrow_move);
+	small_vector& operator=(std::initializer_list<value_type> il) {
+		this->assign(il.begin(), il.end());
+		return *this;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Modifiers
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Swap contents.  Heap arrays are swapped directly; anything in an inline buffer is moved.
+	void swap(small_vector& other);
+	// As vector::shrink_to_fit(), except that if the elements fit in the inline buffer they're
+	// moved back into it.
+	void shrink_to_fit();
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Small Vector Operations
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// True if the elements are stored in the inline buffer
+	bool is_inline() const noexcept { return this->m_data == buffer_base::buffer_data(); }
+	// The base allocator, used once the elements spill out of the inline buffer
+	base_allocator_type get_base_allocator() const noexcept { return this->m_allocator().base(); }
+
+private:
+	// Allocators are tied to their buffer, so they can't be replaced
+	using my_base::set_allocator;
+
+	// True if this and other can take ownership of each other's heap arrays
+	bool shares_heap(const small_vector& other) const;
+	// Take other's content, leaving it empty.  This must already be empty.
+	void move_from(small_vector&& other);
+};
+
+template<typename T, std::size_t N, typename Alloc>
+inline void swap(small_vector<T,N,Alloc>& lhs, small_vector<T,N,Alloc>& rhs) { lhs.swap(rhs); }
+
+// small_vector holds pointers into itself, so is never trivially relocatable
+template<typename T, std::size_t N, typename Alloc>
+struct is_trivially_relocatable<small_vector<T,N,Alloc>> : public std::false_type { };
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Every constructor starts by reserving the inline buffer, which never allocates, so that
+// capacity() is N from the start and the later fills can use it.
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>::small_vector() noexcept(std::is_nothrow_default_constructible<Alloc>::value)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data(), Alloc())) { this->reserve(N); }
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>::small_vector(const Alloc& a) noexcept
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data(), a)) { this->reserve(N); }
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>::small_vector(const size_type initialSize, const Alloc& a)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data(), a)) {
+	this->reserve(N);
+	this->resize(initialSize);
+}
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>::small_vector(const size_type initialSize, const_reference val, const Alloc& a)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data(), a)) {
+	this->reserve(N);
+	this->assign(initialSize, val);
+}
+
+template<typename T, std::size_t N, typename Alloc>
+template<typename InputIterator, typename>
+inline small_vector<T,N,Alloc>::small_vector(InputIterator first, InputIterator last, const Alloc& a)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data(), a)) {
+	this->reserve(N);
+	this->assign(first, last);
+}
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>::small_vector(std::initializer_list<T> init, const Alloc& a)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data(), a)) {
+	this->reserve(N);
+	this->assign(init.begin(), init.end());
+}
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>::small_vector(const small_vector& other)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data(),
+		std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_allocator().base()))) {
+	this->reserve(N);
+	this->assign(other.begin(), other.end());
+}
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>::small_vector(small_vector&& other) noexcept(small_vector::nothrow_move)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data(), other.m_allocator().base())) {
+	this->reserve(N);
+	move_from(std::move(other));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Assignment
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>& small_vector<T,N,Alloc>::operator=(const small_vector& rhs) {
+	// Allocators never propagate, so the vector's copy assignment just copies the elements
+	my_base::operator=(rhs);
+	return *this;
+}
+
+template<typename T, std::size_t N, typename Alloc>
+inline small_vector<T,N,Alloc>& small_vector<T,N,Alloc>::operator=(small_vector&& rhs) noexcept(small_vector::nothrow_move) {
+	if(this != &rhs) {
+		this->clear();
+		move_from(std::move(rhs));
+	}
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Modifiers
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, std::size_t N, typename Alloc>
+inline void small_vector<T,N,Alloc>::swap(small_vector& other) {
+	if(this == &other) { return; }
+
+	if(!is_inline() && !other.is_inline() && shares_heap(other)) {
+		// Both on the heap, so just swap the arrays
+		std::swap(this->m_data, other.m_data);
+		std::swap(this->m_size, other.m_size);
+		std::swap(this->m_capacity, other.m_capacity);
+	} else {
+		// At least one of them is in an inline buffer, which can't change hands
+		small_vector temp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(temp);
+	}
+}
+
+template<typename T, std::size_t N, typename Alloc>
+inline void small_vector<T,N,Alloc>::shrink_to_fit() {
+	// Nothing to give back if we're already in the buffer
+	if(is_inline()) { return; }
+
+	if(this->size() <= N) {
+		// The elements fit in the buffer, so move back in.  (The buffer can't be in use, since the
+		// elements are on the heap.)
+		pointer const oldData = this->m_data;
+		pointer const oldCapacity = this->m_capacity;
+
+		const auto block = this->allocate_at_least(N);
+		pointer const newSize = this->relocate_from_range(block.ptr, this->ibegin(), this->iend());
+		if(oldData) { this->deallocate(oldData, oldCapacity); }
+		this->reset(block.ptr, newSize, block.count);
+
+	} else {
+		my_base::shrink_to_fit();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, std::size_t N, typename Alloc>
+inline bool small_vector<T,N,Alloc>::shares_heap(const small_vector& other) const {
+	return std::allocator_traits<Alloc>::is_always_equal::value || this->m_allocator().base() == other.m_allocator().base();
+}
+
+template<typename T, std::size_t N, typename Alloc>
+inline void small_vector<T,N,Alloc>::move_from(small_vector&& other) {
+	_ASSERTE(this->empty());
+
+	if(other.m_data && !other.is_inline() && shares_heap(other)) {
+		// Other's elements are on the heap, and we can deallocate them, so give up our array and
+		// adopt other's...
+		if(this->m_data) { this->deallocate(this->m_data, this->m_capacity); }
+		this->reset(other.m_data, other.m_size, other.m_capacity);
+		// ...and hand other its inline buffer back
+		other.reset();
+		other.reserve(N);
+
+	} else {
+		// Otherwise, the elements have to be moved individually (or memcpy'd, for trivially
+		// copyable types)
+		this->assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+		other.clear();
+	}
+}
+
+}
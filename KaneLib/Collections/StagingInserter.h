@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////               //////// kane::staging_inserter<VectorType,N,Mutex> ////////           ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A per-thread buffer for appending to a vector shared between threads.  Rather than locking the
+// vector for every push_back() (and dragging the cache line holding its size between cores every
+// time), each thread pushes into its own staging_inserter, which collects up to N elements in a
+// static_vector and then appends them to the shared vector in one go: one lock, one reservation
+// of the destination range, and one bulk copy (a single memmove for trivially copyable types).
+//
+//   std::mutex resultsMutex;
+//   kane::vector<hit> results;
+//   ...on each thread:
+//   kane::staging_inserter<kane::vector<hit>> out(results, resultsMutex);
+//   for(...) { out.push_back(h); }
+//   // Anything left over is flushed when out is destroyed
+//
+// Elements from one thread stay in order, but batches from different threads interleave in
+// whatever order they're flushed.
+//
+// Like pod_back_insert_iterator, a staging_inserter can also be written through as an output
+// iterator, via inserter(): std::copy(first, last, out.inserter()).  The iterator just points back
+// to the staging_inserter, so it's cheap to copy, and only valid as long as the staging_inserter.
+//
+// The staging_inserter itself belongs to one thread; it isn't thread-safe, only the flush is.
+// The destructor flushes, so if flushing can fail (the shared vector can't grow), call flush()
+// explicitly first to deal with the exception; an exception from the destructor's flush
+// terminates the program.
+#pragma once
+
+#include <KaneLib/Collections/ContainerFwd.h>
+#include <KaneLib/Collections/Vector.h>
+#include <KaneLib/Collections/StaticVector.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace kane {
+
+namespace detail {
+	// Enough elements to fill about 4KB, but at least 16
+	template<typename T>
+	constexpr std::size_t default_staging_capacity = std::max<std::size_t>(4096 / sizeof(T), 16);
+}
+
+template<typename VectorType, std::size_t N = detail::default_staging_capacity<typename VectorType::value_type>, typename Mutex = std::mutex>
+class staging_inserter {
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef VectorType							vector_type;
+	typedef Mutex								mutex_type;
+	typedef typename VectorType::value_type		value_type;
+	typedef typename VectorType::size_type		size_type;
+	typedef const value_type&					const_reference;
+	typedef value_type&&						rvalue_reference;
+
+	class iterator;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Stage elements for v, locking m whenever they're flushed into it
+	staging_inserter(VectorType& v, Mutex& m) : m_vector(&v), m_mutex(&m) { }
+	// Copying would duplicate the staged elements
+	staging_inserter(const staging_inserter&) = delete;
+	staging_inserter& operator=(const staging_inserter&) = delete;
+	// Flushes anything still staged
+	~staging_inserter() { flush(); }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Appending
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	void push_back(const_reference val) { emplace_back(val); }
+	void push_back(rvalue_reference rval) { emplace_back(std::move(rval)); }
+	template<typename... Args>
+	void emplace_back(Args&&... args);
+
+	// Output iterator appending through this staging_inserter
+	iterator inserter() noexcept { return iterator(*this); }
+
+	// Append everything staged to the shared vector, in one batch, under the lock.  If that
+	// throws, the staged elements are left where they are (though if they were being moved, some
+	// may have been moved from).
+	void flush();
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Information
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Number of elements waiting to be flushed
+	size_type staged() const noexcept { return m_buffer.size(); }
+	static constexpr size_type staging_capacity() noexcept { return N; }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Iterator
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Works like std::back_insert_iterator: assigning through it appends, and incrementing does
+	// nothing
+	class iterator {
+	public:
+		typedef std::output_iterator_tag iterator_category;
+		typedef void					 value_type;
+		typedef void					 difference_type;
+		typedef void					 pointer;
+		typedef void					 reference;
+
+		explicit iterator(staging_inserter& s) noexcept : m_staging(&s) { }
+
+		iterator& operator=(const_reference val) { m_staging->push_back(val); return *this; }
+		iterator& operator=(rvalue_reference rval) { m_staging->push_back(std::move(rval)); return *this; }
+		iterator& operator*() noexcept { return *this; }
+		iterator& operator++() noexcept { return *this; }
+		iterator operator++(int) noexcept { return *this; }
+
+	private:
+		staging_inserter* m_staging;
+	};
+
+private:
+	kane::static_vector<value_type, N> m_buffer;
+	VectorType* m_vector;
+	Mutex* m_mutex;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Appending
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename VectorType, std::size_t N, typename Mutex>
+template<typename... Args>
+inline void staging_inserter<VectorType,N,Mutex>::emplace_back(Args&&... args) {
+	if(m_buffer.size() == N) { flush(); }
+	m_buffer.emplace_back(std::forward<Args>(args)...);
+}
+
+template<typename VectorType, std::size_t N, typename Mutex>
+inline void staging_inserter<VectorType,N,Mutex>::flush() {
+	if(m_buffer.empty()) { return; }
+	{
+		std::lock_guard<Mutex> lock(*m_mutex);
+		m_vector->insert(m_vector->end(), std::make_move_iterator(m_buffer.begin()), std::make_move_iterator(m_buffer.end()));
+	}
+	m_buffer.clear();
+}
+
+}
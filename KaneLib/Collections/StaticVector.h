@@ -0,0 +1,269 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////               //////// kane::static_vector<T,N,OverflowPolicy> ////////             ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A kane::vector with a fixed capacity of N elements, stored inside the object itself.  It never
+// uses the heap: growing past N elements is an overflow, handled by OverflowPolicy (see below).
+//
+// Like small_vector (see SmallVector.h), static_vector is a kane::vector using a special allocator
+// which hands out the inline buffer, so the whole vector interface, including take(), replace()
+// and xinsert(), is available and works unchanged.  Any request the buffer can't satisfy is an
+// overflow, and since the vector always asks for the new array before touching its elements, an
+// overflowing operation leaves the static_vector unchanged.
+//
+// Caveats, all following from the fact that the vector can only ever have the one array:
+//  - Inserting a single-pass (input iterator) range anywhere but the end needs temporary arrays,
+//    so always overflows.  Copy the range somewhere first.
+//  - shrink_to_fit() does nothing.
+//  - Don't copy, move or swap a static_vector through a reference to its vector base.  The
+//    static_vector versions of those operations copy or move the elements instead.
+#pragma once
+
+#include <KaneLib/Collections/ContainerFwd.h>
+#include <KaneLib/Collections/Vector.h>
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace kane {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Overflow policies
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// What a fixed-capacity container does when asked to hold more than it can.  A policy provides
+//   static void overflow(std::size_t requested, std::size_t capacity)
+// which must not return.
+
+// Assert in debug builds.  There's nowhere to put the elements, so release builds abort().
+struct overflow_assert {
+	[[noreturn]] static void overflow(std::size_t, std::size_t) {
+		_ASSERTE(!"Fixed-capacity container overflowed");
+		std::abort();
+	}
+};
+
+// Throw std::length_error
+struct overflow_throw {
+	[[noreturn]] static void overflow(std::size_t, std::size_t) {
+		throw std::length_error("Fixed-capacity container overflowed");
+	}
+};
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// static_vector_allocator
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Allocator for static_vector.  Hands out the buffer for requests of up to N elements, as long as
+// it isn't already in use; anything else is an overflow.  An allocator with a NULL buffer can't
+// allocate anything at all.  Two static_vector_allocators are only equal if they share a buffer.
+template<typename T, std::size_t N, typename OverflowPolicy>
+class static_vector_allocator {
+public:
+	typedef T				value_type;
+	typedef T*				pointer;
+	typedef const T*		const_pointer;
+	typedef std::size_t		size_type;
+	typedef std::ptrdiff_t	difference_type;
+
+	typedef std::false_type propagate_on_container_copy_assignment;
+	typedef std::false_type propagate_on_container_move_assignment;
+	typedef std::false_type propagate_on_container_swap;
+	typedef std::false_type is_always_equal;
+
+	// Only to keep allocator_traits happy; rebinding to anything but T gives an allocator that
+	// can't use the buffer.
+	template<typename U> struct rebind { typedef static_vector_allocator<U, N, OverflowPolicy> other; };
+
+	explicit static_vector_allocator(T* const buffer) : m_buffer(buffer), m_bufferUsed(buffer == NULL) { }
+
+	static_vector_allocator select_on_container_copy_construction() const { return static_vector_allocator(NULL); }
+
+	///////////////////////////////////
+	// Allocation
+	T* allocate(const size_type n) {
+		if(n > N || m_bufferUsed) { OverflowPolicy::overflow(n, N); }
+		m_bufferUsed = true;
+		return m_buffer;
+	}
+
+	kane::allocation_result<T*, size_type> allocate_at_least(const size_type n) { return { allocate(n), N }; }
+
+	void deallocate(T* const p, size_type) {
+		_ASSERTE(p == m_buffer);
+		m_bufferUsed = false;
+	}
+
+	size_type max_size() const { return N; }
+
+	friend bool operator==(const static_vector_allocator& lhs, const static_vector_allocator& rhs) { return lhs.m_buffer == rhs.m_buffer; }
+	friend bool operator!=(const static_vector_allocator& lhs, const static_vector_allocator& rhs) { return lhs.m_buffer != rhs.m_buffer; }
+
+private:
+	T* m_buffer;
+	bool m_bufferUsed;
+};
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// static_vector
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T, std::size_t N, typename OverflowPolicy = overflow_assert>
+class static_vector : private detail::inline_buffer<T, N>, public vector<T, detail::static_vector_allocator<T, N, OverflowPolicy>> {
+private:
+	typedef detail::inline_buffer<T, N>											buffer_base;
+	typedef vector<T, detail::static_vector_allocator<T, N, OverflowPolicy>>	my_base;
+	typedef static_vector<T, N, OverflowPolicy>									my_type;
+
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef typename my_base::allocator_type	allocator_type;
+	typedef OverflowPolicy						overflow_policy;
+	typedef typename my_base::value_type		value_type;
+	typedef typename my_base::const_reference	const_reference;
+	typedef typename my_base::size_type			size_type;
+
+	// The fixed capacity
+	static constexpr size_type static_capacity = N;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	static_vector() noexcept;
+	// Construct vector with initialSize default-constructed elements
+	explicit static_vector(size_type initialSize);
+	// Construct vector with initialSize copies of given value
+	static_vector(size_type initialSize, const_reference val);
+	// Construct vector containing elements in given iterator range
+	template<typename InputIterator, typename = enable_if_iterator_t<InputIterator>>
+	static_vector(InputIterator first, InputIterator last);
+	// Initialiser list construction
+	static_vector(std::initializer_list<T> init);
+	// Copy and move construction copy or move each element
+	static_vector(const static_vector& other);
+	static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Assignment
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	static_vector& operator=(const static_vector& rhs);
+	static_vector& operator=(static_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+	static_vector& operator=(std::initializer_list<value_type> il) {
+		this->assign(il.begin(), il.end());
+		return *this;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Modifiers
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Swap contents element by element
+	void swap(static_vector& other);
+	// Nothing to give back
+	void shrink_to_fit() noexcept { }
+
+private:
+	// The allocator is tied to the buffer, so can't be replaced
+	using my_base::set_allocator;
+};
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline void swap(static_vector<T,N,OverflowPolicy>& lhs, static_vector<T,N,OverflowPolicy>& rhs) { lhs.swap(rhs); }
+
+// static_vector holds a pointer into itself, so is never trivially relocatable
+template<typename T, std::size_t N, typename OverflowPolicy>
+struct is_trivially_relocatable<static_vector<T,N,OverflowPolicy>> : public std::false_type { };
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Every constructor starts by reserving the buffer, so capacity() is always N.
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline static_vector<T,N,OverflowPolicy>::static_vector() noexcept
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data())) { this->reserve(N); }
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline static_vector<T,N,OverflowPolicy>::static_vector(const size_type initialSize)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data())) {
+	this->reserve(N);
+	this->resize(initialSize);
+}
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline static_vector<T,N,OverflowPolicy>::static_vector(const size_type initialSize, const_reference val)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data())) {
+	this->reserve(N);
+	this->assign(initialSize, val);
+}
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+template<typename InputIterator, typename>
+inline static_vector<T,N,OverflowPolicy>::static_vector(InputIterator first, InputIterator last)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data())) {
+	this->reserve(N);
+	this->assign(first, last);
+}
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline static_vector<T,N,OverflowPolicy>::static_vector(std::initializer_list<T> init)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data())) {
+	this->reserve(N);
+	this->assign(init.begin(), init.end());
+}
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline static_vector<T,N,OverflowPolicy>::static_vector(const static_vector& other)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data())) {
+	this->reserve(N);
+	this->assign(other.begin(), other.end());
+}
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline static_vector<T,N,OverflowPolicy>::static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+	: buffer_base(), my_base(allocator_type(buffer_base::buffer_data())) {
+	this->reserve(N);
+	this->assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+	other.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Assignment
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline static_vector<T,N,OverflowPolicy>& static_vector<T,N,OverflowPolicy>::operator=(const static_vector& rhs) {
+	// Allocators never propagate, so the vector's copy assignment just copies the elements
+	my_base::operator=(rhs);
+	return *this;
+}
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline static_vector<T,N,OverflowPolicy>& static_vector<T,N,OverflowPolicy>::operator=(static_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) {
+	if(this != &rhs) {
+		this->assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+		rhs.clear();
+	}
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Modifiers
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, std::size_t N, typename OverflowPolicy>
+inline void static_vector<T,N,OverflowPolicy>::swap(static_vector& other) {
+	if(this == &other) { return; }
+
+	// Swap the common prefix in place, then move the longer vector's tail across
+	static_vector& shorter = (this->size() < other.size()) ? *this : other;
+	static_vector& longer = (this->size() < other.size()) ? other : *this;
+	const size_type common = shorter.size();
+
+	std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+	shorter.insert(shorter.end(), std::make_move_iterator(longer.begin() + common), std::make_move_iterator(longer.end()));
+	longer.erase(longer.begin() + common, longer.end());
+}
+
+}
@@ -63,6 +63,46 @@ namespace kane {
 // For certain, very large types, using the "complex" insert routine may be preferable.
 template<typename T> struct use_simple_insert : public std::true_type { };
 
+///////////////////////////////////////
+// is_trivially_relocatable type trait
+///////////////////////////////////////
+// Specialise this trait to true for types which can be relocated--moved to a new address, with the
+// original destroyed--by simply copying their bytes and forgetting about the original.  Most types
+// which own their resources through a pointer qualify.  When this is true, vector (and other array 
+// containers) will use a single memmove() to shuffle elements around during reallocation, gap-
+// making, and erase, instead of move-constructing and destroying each element individually.
+// Trivially copyable types are trivially relocatable by default.  We also specialise it for 
+// std::unique_ptr, std::allocator and kane::vector below.
+// Types which contain pointers into themselves are NOT trivially relocatable.  Notably, that 
+// includes libstdc++'s std::string (its small-string buffer is referenced by its own data 
+// pointer) and MSVC containers with debug iterators enabled (their proxy points back to the 
+// container), so std::string isn't specialised here.
+template<typename T> struct is_trivially_relocatable : public std::is_trivially_copyable<T> { };
+template<typename T> struct is_trivially_relocatable<std::allocator<T>> : public std::true_type { };
+template<typename T, typename Deleter> 
+struct is_trivially_relocatable<std::unique_ptr<T, Deleter>> : public is_trivially_relocatable<Deleter> { };
+
+///////////////////////////////////////
+// use_parallel_copy type trait
+///////////////////////////////////////
+// Specialise this trait to true to have vectors of T split very large copies across threads (see
+// kane::parallel_copy() in Algorithms/Parallel.h): relocating the elements when the vector 
+// reallocates or shrinks, and copy-constructing one vector from another.  Only copies of at least 
+// KANELIB_PARALLEL_COPY_THRESHOLD bytes (64MB by default) are split, and only trivially copyable
+// types qualify.  Off by default, because it wakes up a thread pool the program may not want.
+template<typename T> struct use_parallel_copy : public std::false_type { };
+
+///////////////////////////////////////
+// is_zero_initialisable type trait
+///////////////////////////////////////
+// True for types whose value-initialised state is all zero bytes, so an array of them can be 
+// created by zeroing memory (or getting it pre-zeroed from the allocator) rather than constructing 
+// each element.  This is what the kane::zeroed constructor and resize() overload rely on.  By
+// default, that's trivial types other than pointers to members (which are -1 when null on most
+// ABIs).  Specialise it for trivially copyable types that happen to be fine with zeroes.
+template<typename T> struct is_zero_initialisable : public std::bool_constant<std::is_trivially_copyable<T>::value && 
+	std::is_trivially_default_constructible<T>::value && !std::is_member_pointer<T>::value> { };
+
 template<typename VectorType> class pod_back_insert_iterator;
 
 template<typename T, typename Alloc = std::allocator<T>>
@@ -113,6 +153,10 @@ public:
 	// Construct vector with initialSize default-constructed elements
 	explicit vector(size_type initialSize);
 	vector(size_type initialSize, const Alloc& allocator);
+	// Construct vector with initialSize zero-filled elements, getting the memory pre-zeroed from 
+	// the allocator if it can (non-standard extension).  Requires is_zero_initialisable<T>.
+	vector(kane::zeroed_t, size_type initialSize);
+	vector(kane::zeroed_t, size_type initialSize, const Alloc& allocator);
 	// Construct vector with initialSize copies of given value
 	vector(size_type initialSize, const_reference val);
 	vector(size_type initialSize, const_reference val, const Alloc& allocator);
@@ -121,6 +165,14 @@ public:
 	vector(InputIterator first, InputIterator last);
 	template<typename InputIterator, typename = enable_if_iterator_t<InputIterator>> 
 	vector(InputIterator first, InputIterator last, const Alloc& allocator);
+	// As above, but construct the elements across threads, each first-touching its own pages (non-
+	// standard extension; see kane::par).  Ranges that aren't random access are copied serially.
+	vector(kane::parallel_t, size_type initialSize, const_reference val);
+	vector(kane::parallel_t, size_type initialSize, const_reference val, const Alloc& allocator);
+	template<typename InputIterator, typename = enable_if_iterator_t<InputIterator>> 
+	vector(kane::parallel_t, InputIterator first, InputIterator last);
+	template<typename InputIterator, typename = enable_if_iterator_t<InputIterator>> 
+	vector(kane::parallel_t, InputIterator first, InputIterator last, const Alloc& allocator);
 	// Copy construct from another vector
 	vector(const vector& other);
 	vector(const vector& other, const Alloc& allocator);
@@ -149,6 +201,10 @@ public:
 	// Assign from iterator pair
 	template<typename InputIterator, typename = enable_if_iterator_t<InputIterator>>
 	void assign(InputIterator first, InputIterator last);
+	// Assign, constructing the new elements across threads (non-standard extension; see kane::par)
+	void assign(kane::parallel_t, const size_type newSize, const_reference elem);
+	template<typename InputIterator, typename = enable_if_iterator_t<InputIterator>>
+	void assign(kane::parallel_t, InputIterator first, InputIterator last);
 	// Assign from initialiser list
 	void assign(std::initializer_list<value_type> il) {
 		assign(il.begin(), il.end());
@@ -190,6 +246,7 @@ public:
 	void reserve(size_type neededSize);
 	void resize(size_type newSize);
 	void resize(size_type newSize, const_reference elem);
+	void resize(size_type newSize, kane::zeroed_t);	// zero-fills new elements, non-standard extension
 	void shrink_to_fit();
 	// Allocator
 	allocator_type get_allocator() const noexcept;
@@ -345,7 +402,10 @@ public:
 
 	// Write the contents of a vector to an ostream.  The elements are written separated by spaces,
 	// with the entire sequence surrounded by square brackets.  (ie, [0 1 2 3 4])
-	// Obviously, this requires an << operator for type T
+	// Numbers (other than characters and bools) are formatted with format_to() and written in one
+	// go, so the stream's formatting flags don't apply to them, and floating-point numbers come 
+	// out in their shortest round-trip form rather than to the stream's precision.  Anything else
+	// needs an << operator for type T, and is written an element at a time.
 	friend std::ostream& operator<<(std::ostream& stream, const vector& vec);
 
 protected:
@@ -377,6 +437,10 @@ protected:
 	template<typename InputIterator, typename = enable_if_iterator_t<InputIterator>>
 	size_type select_capacity_from_range(InputIterator first, InputIterator last);
 
+	// Construct from iterator range across threads, if it's random access
+	template<typename InputIterator>
+	void do_parallel_construct_range(InputIterator first, InputIterator last);
+
 	///////////////////////////////////////////////////////
 	// Assignment Helpers
 	///////////////////////////////////////////////////////
@@ -400,6 +464,8 @@ protected:
 
 	// Append N default-constructed elements
 	pointer append_defaults(size_type sz);
+	// Append N zero-filled elements
+	pointer append_zeroed(size_type sz);
 
 	///////////////////////////////////////////////////////
 	// Erase Helpers
@@ -571,6 +637,64 @@ protected:
 template<typename T, typename Alloc>
 pod_back_insert_iterator<vector<T,Alloc>> pod_back_inserter(vector<T,Alloc>& v);
 
+///////////////////////////////////
+// Text formatting and parsing
+///////////////////////////////////
+namespace detail {
+	// Numbers std::to_chars() formats the way an ostream would: not bools or characters, which
+	// streams write as words and letters
+	template<typename T>
+	constexpr bool is_to_chars_formattable = std::is_floating_point<T>::value || (std::is_integral<T>::value && 
+		!std::is_same<T, bool>::value && !std::is_same<T, char>::value && !std::is_same<T, signed char>::value && 
+		!std::is_same<T, unsigned char>::value && !std::is_same<T, wchar_t>::value && !std::is_same<T, char16_t>::value && 
+		!std::is_same<T, char32_t>::value);
+
+	// Number of decimal digits in n
+	constexpr std::size_t decimal_digits(std::size_t n) noexcept {
+		std::size_t digits = 1;
+		for(; n >= 10; n /= 10) { ++digits; }
+		return digits;
+	}
+}
+
+// Append the elements of vec (or [first, last)) to the end of buffer as text, separated by 
+// separator, with std::to_chars(): integers in decimal, and floating-point numbers in the shortest
+// form that reads back as the same value.  No locales, no virtual calls, and no allocation beyond
+// growing buffer, which can be kept and reused (clear() it) to avoid even that.  Returns buffer.
+//   kane::vector<char> line;
+//   kane::format_to(line, samples, ",");		// CSV
+template<typename CharAlloc, typename T, typename Alloc>
+vector<char, CharAlloc>& format_to(vector<char, CharAlloc>& buffer, const vector<T, Alloc>& vec, std::string_view separator = " ");
+template<typename CharAlloc, typename T>
+vector<char, CharAlloc>& format_to(vector<char, CharAlloc>& buffer, const T* first, const T* last, std::string_view separator = " ");
+
+// Where parse_into() stopped: ptr is end if everything parsed, or the start of the token that
+// didn't (with ec saying why); count is the number of values appended either way
+struct parse_result {
+	const char* ptr;
+	std::size_t count;
+	std::errc ec;
+};
+
+// Append the numbers in the text [first, last) to vec, converting them with std::from_chars():
+// integers in decimal, floating-point numbers in fixed or scientific notation.  The numbers are
+// separated by runs of any of the characters in delimiters (which are also skipped at either
+// end); the delimiters are found a vector register at a time (see detail::byte_set), and each
+// number is converted straight into vec's spare capacity, which grows geometrically.  Like
+// from_chars(), and unlike strtod() and streams, it takes no notice of locales or leading '+'s.
+// Stops at the first token that isn't entirely a number, or is out of range for T, leaving the
+// numbers before it in vec.
+//   kane::vector<double> prices;
+//   const kane::parse_result r = kane::parse_into(prices, text.data(), text.data() + text.size());
+//   if(r.ec != std::errc()) { ... }
+template<typename T, typename Alloc>
+parse_result parse_into(vector<T, Alloc>& vec, const char* first, const char* last, std::string_view delimiters = " \t\r\n,");
+
+// A vector is just three pointers and an allocator, so it's trivially relocatable as long as its 
+// allocator is.
+template<typename T, typename Alloc> 
+struct is_trivially_relocatable<vector<T,Alloc>> : public is_trivially_relocatable<Alloc> { };
+
 }
 
 // Implementation
@@ -78,6 +78,18 @@ template<typename T, typename Alloc>
 inline vector<T,Alloc>::vector(size_type initialSize, const Alloc& a) 
 	: my_base(initialSize, a) { do_construct(initialSize); }
 
+template<typename T, typename Alloc> 
+inline vector<T,Alloc>::vector(kane::zeroed_t, size_type initialSize) 
+	: my_base(kane::zeroed, initialSize) { 
+	static_assert(kane::is_zero_initialisable<T>::value && value_has_trivial_copy, "kane::zeroed needs a zero-initialisable value_type and an allocator that doesn't customise construct()");
+}
+
+template<typename T, typename Alloc> 
+inline vector<T,Alloc>::vector(kane::zeroed_t, size_type initialSize, const Alloc& a) 
+	: my_base(kane::zeroed, initialSize, a) { 
+	static_assert(kane::is_zero_initialisable<T>::value && value_has_trivial_copy, "kane::zeroed needs a zero-initialisable value_type and an allocator that doesn't customise construct()");
+}
+
 template<typename T, typename Alloc> 
 inline vector<T,Alloc>::vector(size_type initialSize, const_reference value) 
 	: my_base(initialSize) { do_construct(initialSize, value); }
@@ -86,6 +98,14 @@ template<typename T, typename Alloc>
 inline vector<T,Alloc>::vector(size_type initialSize, const_reference value, const Alloc& a) 
 	: my_base(initialSize, a) { do_construct(initialSize, value); }
 
+template<typename T, typename Alloc> 
+inline vector<T,Alloc>::vector(kane::parallel_t, size_type initialSize, const_reference value) 
+	: my_base(initialSize) { if(initialSize > 0) { iend(parallel_construct_n(m_data, initialSize, value)); } }
+
+template<typename T, typename Alloc> 
+inline vector<T,Alloc>::vector(kane::parallel_t, size_type initialSize, const_reference value, const Alloc& a) 
+	: my_base(initialSize, a) { if(initialSize > 0) { iend(parallel_construct_n(m_data, initialSize, value)); } }
+
 ///////////////////////////////////////
 // Construct from range
 ///////////////////////////////////////
@@ -100,6 +120,16 @@ template<typename InputIterator, typename>
 inline vector<T,Alloc>::vector(InputIterator first, InputIterator last, const Alloc& a) 
 	: my_base(select_capacity_from_range(first, last), a) { do_construct_range(first, last); }
 
+template<typename T, typename Alloc>
+template<typename InputIterator, typename> 
+inline vector<T,Alloc>::vector(kane::parallel_t, InputIterator first, InputIterator last) 
+	: my_base(select_capacity_from_range(first, last)) { do_parallel_construct_range(first, last); }
+
+template<typename T, typename Alloc> 
+template<typename InputIterator, typename> 
+inline vector<T,Alloc>::vector(kane::parallel_t, InputIterator first, InputIterator last, const Alloc& a) 
+	: my_base(select_capacity_from_range(first, last), a) { do_parallel_construct_range(first, last); }
+
 ///////////////////////////////////////
 // Copy construction
 ///////////////////////////////////////
@@ -259,6 +289,32 @@ __forceinline void vector<T,Alloc>::assign(InputIterator first, InputIterator la
 	do_assign(first, last, tag());
 }
 
+template<typename T, typename Alloc> 
+inline void vector<T,Alloc>::assign(kane::parallel_t, size_type newSize, const_reference val) {
+	// Everything's getting rebuilt from scratch, and val might be one of our elements
+	const value_type value(val);
+	clear();
+	if(newSize != 0) {
+		reserve(newSize);
+		iend(parallel_construct_n(m_data, newSize, value));
+	}
+}
+
+template<typename T, typename Alloc>
+template<typename InputIterator, typename>
+inline void vector<T,Alloc>::assign(kane::parallel_t, InputIterator first, InputIterator last) {
+	if constexpr(kane::is_random_access_iterator_v<InputIterator>) {
+		clear();
+		const size_type newSize = size_type(std::distance(first, last));
+		if(newSize != 0) {
+			reserve(newSize);
+			iend(parallel_copy_construct_from_range(m_data, first, last));
+		}
+	} else {
+		assign(first, last);
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Iterators
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -396,6 +452,20 @@ inline void vector<T,Alloc>::resize(size_type newSize) {
 	}
 }
 
+template<typename T, typename Alloc> 
+inline void vector<T,Alloc>::resize(size_type newSize, kane::zeroed_t) {
+	static_assert(kane::is_zero_initialisable<T>::value && value_has_trivial_copy, "kane::zeroed needs a zero-initialisable value_type and an allocator that doesn't customise construct()");
+	const size_type currentSize = size();
+	if(newSize < currentSize) { 
+		truncate_internal(ibegin() + newSize);
+	} else {
+		const size_type elementsAdded = newSize - currentSize;
+		if(elementsAdded != 0) {
+			append_zeroed(elementsAdded);
+		}
+	}
+}
+
 template<typename T, typename Alloc>
 inline void vector<T,Alloc>::shrink_to_fit() { 
 	if(m_size == m_data) {
@@ -403,12 +473,23 @@ inline void vector<T,Alloc>::shrink_to_fit() {
 		if(m_data) { deallocate(m_data, m_capacity); reset(); }
 
 	} else if(m_size != m_capacity) {
-		// Allocate a new, smaller array and move our elements over
+		// If the allocator can shrink the array in place, nothing needs to move
+		if(resize_in_place(size())) { return; }
+
+		// If the elements can be relocated bytewise and the allocator can resize blocks, let it 
+		// shrink the array, which might not need to copy anything
+		if constexpr(alloc_can_reallocate && value_has_trivial_relocate) {
+			const size_type oldSize = size();
+			pointer const newData = reallocate_array(m_data, capacity(), oldSize);
+			reset(newData, newData + oldSize, oldSize);
+			return;
+		}
+
+		// Allocate a new, smaller array and relocate our elements over
 		pointer const newData = allocate(size());
-		pointer const newSize = move_construct_from_range(newData, ibegin(), iend());
+		pointer const newSize = relocate_to_new_array(newData, ibegin(), iend());
 
 		// Deallocate the current array
-		destroy(ibegin(), iend());
 		deallocate(m_data, m_capacity);
 
 		// Set the new array
@@ -578,7 +659,7 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::xinsert(const_iterato
 
 	} else {
 		pointer const newPosition = make_gap_1(position);
-		if(value_has_trivial_destroy || newPosition != position) {
+		if(gap_uses_construct || newPosition != position) {
 			construct(newPosition, val);
 		} else {
 			*newPosition = val;
@@ -598,7 +679,7 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::xinsert(const_iterato
 
 	} else {
 		pointer const newPosition = make_gap_1(position);
-		if(value_has_trivial_destroy || newPosition != position) {
+		if(gap_uses_construct || newPosition != position) {
 			construct(newPosition, std::move(val));
 		} else {
 			*newPosition = std::move(val);
@@ -622,18 +703,18 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::xinsert(const_iterato
 	} else {
 		// ranges.first is the start of the initialised segment, ranges.second is the start of the 
 		// uninitialised segment.  newPosition is the new location of the element at position
-		const std::pair<pointer, pointer> ranges = make_gap_n(position);
+		const std::pair<pointer, pointer> ranges = make_gap_n(position, count);
 		pointer const newPosition = ranges.first + count;
 
-		// If value_has_trivial_destory, we can use copy construction for the whole range.
+		// If gap_uses_construct, we can use copy construction for the whole range.
 		// Otherwise, we need to split it up.
 		// TODO: Check if the compiler would optimise this without needing the test in this method
-		if(value_has_trivial_destroy) {
+		if(gap_uses_construct) {
 			construct_range(ranges.first, newPosition, val);
 		} else {
-			// Copy construct the first range, copy assign the second range
-			construct_range(ranges.first, ranges.second, val);
-			assign_range(ranges.second, newPosition, val);
+			// Copy assign the initialised range, copy construct the uninitialised range
+			assign_range(ranges.first, ranges.second, val);
+			construct_range(ranges.second, newPosition, val);
 		}
 
 		return pointer_to_iterator(ranges.first);
@@ -665,7 +746,7 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::emplace(const_iterato
 		return pointer_to_iterator(iend() - 1);
 	} else {
 		pointer const newPosition = make_gap_1(position);
-		if(value_has_trivial_destroy || position != newPosition) {
+		if(gap_uses_construct || position != newPosition) {
 			construct(newPosition);
 		} else {
 			*newPosition = value_type();
@@ -819,9 +900,9 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::replace(const_iterato
 		// Increasing the size.  By enough to require a reallocation?
 		const size_type insertSize = count - rangeSize;
 
-		if(!many(insertSize)) {
-			// Increasing the size, but not by enough to force a reallocation.  First, move the suffix 
-			// forward...
+		if(!many(insertSize) || resize_in_place(best_capacity(size() + insertSize))) {
+			// Increasing the size, but not by enough to force a reallocation (or the allocator grew
+			// the array in place, moving nothing).  First, move the suffix forward...
 			pointer const ufirst = move_forward_n(last, insertSize);
 			pointer const ulast = first + count;
 			// Default-assign into the initialised elements
@@ -839,8 +920,9 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::replace(const_iterato
 			// we can skip moving the elements to be overwritten, since they're to be erased anyway.
 			// Allocate the best amount...
 			const size_type oldCapacity = capacity();
-			const size_type newCapacity = best_capacity(size() + insertSize);
-			const pointer newData = allocate(newCapacity);
+			const auto block = allocate_at_least(best_capacity(size() + insertSize));
+			const size_type newCapacity = block.count;
+			pointer const newData = block.ptr;
 		
 			// Move the prefix over...
 			const pointer insertFirst = move_construct_from_range(newData, ibegin(), first);
@@ -891,11 +973,12 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::replace(const_iterato
 		// Increasing the size.  By enough to require a reallocation?
 		const size_type insertSize = count - rangeSize;
 
-		if(!many(insertSize)) {
-			// Increasing the size, but not by enough to force a reallocation.  Gotta get clever 
-			// here, because we have no guarantee that val isn't in the suffix.  We'll assign the 
-			// first element of the replaced range, and then use that element as the exemplar for
-			// the rest of the function.
+		if(!many(insertSize) || resize_in_place(best_capacity(size() + insertSize))) {
+			// Increasing the size, but not by enough to force a reallocation (or the allocator grew
+			// the array in place, so val hasn't moved).  Gotta get clever here, because we have no
+			// guarantee that val isn't in the suffix.  We'll assign the first element of the 
+			// replaced range, and then use that element as the exemplar for the rest of the 
+			// function.
 			*first = val;
 
 			// Now, move the suffix forward
@@ -918,8 +1001,9 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::replace(const_iterato
 			// the exemplar.
 			// Allocate the best amount...
 			const size_type oldCapacity = capacity();
-			const size_type newCapacity = best_capacity(size() + insertSize);
-			const pointer newData = allocate(newCapacity);
+			const auto block = allocate_at_least(best_capacity(size() + insertSize));
+			const size_type newCapacity = block.count;
+			pointer const newData = block.ptr;
 
 			// Assign our exemplar...
 			pointer const exemplar = newData + (first - ibegin());
@@ -1006,6 +1090,17 @@ inline void vector<T,Alloc>::do_construct(size_type initialSize, const_reference
 	if(initialSize > 0) { iend(construct_n(m_data, initialSize, val)); }
 }
 
+template<typename T, typename Alloc>
+template<typename InputIterator> 
+inline void vector<T,Alloc>::do_parallel_construct_range(InputIterator first, InputIterator last) {
+	if constexpr(kane::is_random_access_iterator_v<InputIterator>) {
+		// The base class constructor already allocated exactly enough
+		if(first != last) { iend(parallel_copy_construct_from_range(m_data, first, last)); }
+	} else {
+		do_construct_range(first, last);
+	}
+}
+
 template<typename T, typename Alloc>
 template<typename InputIterator, typename> 
 inline typename vector<T,Alloc>::size_type vector<T,Alloc>::select_capacity_from_range(InputIterator first, InputIterator last) {
@@ -1035,7 +1130,11 @@ void vector<T,Alloc>::do_construct_range(InputIterator first, InputIterator last
 	// If we're done, awesome.
 	if(first == last) { return; }
 
-	// Otherwise, we still have elements to insert, so we'll have to do horrible things
+	// Otherwise, grow in place if the allocator can, or else do horrible things
+	if constexpr(alloc_can_expand) {
+		append_range(first, last, std::input_iterator_tag());
+		return;
+	}
 	const size_type numCap = capacity();
 	const horrible_insert_helper horrible(insert_horrible(numCap, numCap, numCap, first, last));
 	// Move in the initially-grabbed elements
@@ -1149,15 +1248,22 @@ template<typename InputIterator>
 inline typename vector<T,Alloc>::pointer vector<T,Alloc>::append_range(InputIterator first, InputIterator last, const std::input_iterator_tag) {
 	// If uninitialised, allocate space for at least 16 elements (chances are, this'll shake out to
 	// 64 or 128 bytes, so one or two cache lines).
-	if(!m_data) { reset(allocate(16), 16); }
+	if(!m_data) { 
+		const auto block = allocate_at_least(16);
+		reset(block.ptr, block.count); 
+	}
 
 	const size_type oldSize = size();
 
-	// First, try appending into the empty space
-	if(!full()) {
-		pointer position;
-		std::tie(position, first) = checked_copy_construct_range(ubegin(), uend(), first, last);
-		iend(position);
+	// First, try appending into the empty space, growing it in place for as long as the allocator
+	// can
+	for(;;) {
+		if(!full()) {
+			pointer position;
+			std::tie(position, first) = checked_copy_construct_range(ubegin(), uend(), first, last);
+			iend(position);
+		}
+		if(first == last || !resize_in_place(next_capacity())) { break; }
 	}
 
 	// If not done, do horrible things
@@ -1206,16 +1312,61 @@ typename typename vector<T,Alloc>::pointer vector<T,Alloc>::append_defaults(size
 	return oldEnd;
 }
 
+template<typename T, typename Alloc> 
+inline typename vector<T,Alloc>::pointer vector<T,Alloc>::append_zeroed(size_type sz) {
+	const size_type oldSize = size();
+	const size_type newSize = oldSize + sz;
+
+	// If the allocator can grow the array in place into zeroed memory, only the old spare capacity
+	// needs clearing
+	if constexpr(alloc_can_expand_zeroed) {
+		if(newSize > capacity() && m_data && try_expand_zeroed(m_data, capacity(), newSize)) {
+			pointer const oldEnd = iend();
+			std::memset(oldEnd, 0, (capacity() - oldSize) * sizeof(value_type));
+			reset(m_data, oldEnd + sz, newSize);
+			return oldEnd;
+		}
+	}
+
+	// If the allocator hands out pre-zeroed memory and we have to move anyway, take a fresh 
+	// zeroed array and copy the old elements over the front of it, leaving the new ones untouched
+	if constexpr(alloc_can_allocate_zeroed) {
+		if(newSize > capacity() && !resize_in_place(newSize)) {
+			const auto block = allocate_zeroed(newSize);
+			if(m_data) {
+				relocate_to_new_array(block.ptr, ibegin(), iend());
+				deallocate(m_data, m_capacity);
+			}
+			reset(block.ptr, block.ptr + newSize, block.count);
+			return block.ptr + oldSize;
+		}
+	}
+
+	// Otherwise, the new elements' memory may hold anything, so clear it ourselves
+	reserve(newSize);
+	pointer const oldEnd = iend();
+	std::memset(oldEnd, 0, sz * sizeof(value_type));
+	iend(oldEnd + sz);
+	return oldEnd;
+}
+
 ///////////////////////////////////////////////////////////
 // Erase helpers
 ///////////////////////////////////////////////////////////
 
 template<typename T, typename Alloc> 
 inline typename vector<T,Alloc>::pointer vector<T,Alloc>::erase_internal(pointer first, pointer last) {
-	// Move the suffix backward onto the elements to be erased, then erase everything from the end
-	// of the suffix to the end of the allocated space.
-	// So easy!
-	truncate_internal( move_assign_from_range(first, last, iend()) );
+	if constexpr(value_has_trivial_relocate) {
+		// Destroy the elements to be erased, then relocate the suffix down over the hole with a
+		// single memmove.
+		destroy(first, last);
+		iend( relocate_from_range(first, last, iend()) );
+	} else {
+		// Move the suffix backward onto the elements to be erased, then erase everything from the end
+		// of the suffix to the end of the allocated space.
+		// So easy!
+		truncate_internal( move_assign_from_range(first, last, iend()) );
+	}
 	return first;
 }
 template<typename T, typename Alloc> 
@@ -1236,6 +1387,16 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::insert_range(pointer p
 	if(first == last) { 
 		return position; 
 	}
+
+	// If the allocator can grow the array in place, append the new elements (which only moves 
+	// anything if it runs out of room) and rotate them into position, like MSVC does
+	if constexpr(alloc_can_expand) {
+		const size_type index = position - ibegin();
+		const size_type oldSize = size();
+		append_range(first, last, std::input_iterator_tag());
+		std::rotate(ibegin() + index, ibegin() + oldSize, iend());
+		return ibegin() + index;
+	}
 	
 	// This MAY require a horribleness.  If it does, it'll involve rearranging a bunch of chunks of
 	// this vector.  We can simplify that with this array:
@@ -1362,10 +1523,10 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::insert_range(pointer p
 	// Get the number of elements to insert
 	const size_type count = static_cast<size_type>(std::distance(first, last));
 	
-	if(!many(count)) {
-		// New elements will fit within our existing capacity.  Make space for them.  The space 
-		// will be split into an initialised prefix and an uninitialised suffix.  ufirst points to
-		// the first uninitialised element
+	if(!many(count) || resize_in_place(best_capacity(size() + count))) {
+		// New elements will fit within our existing capacity (possibly just grown in place).  Make
+		// space for them.  The space will be split into an initialised prefix and an uninitialised
+		// suffix.  ufirst points to the first uninitialised element
 		pointer const ufirst = move_forward_n(position, count);
 
 		if(value_has_trivial_destroy) {
@@ -1387,8 +1548,9 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::insert_range(pointer p
 	} else {
 		// Have to reallocate.  Allocate the new array first
 		const size_type oldCapacity = capacity();
-		const size_type newCapacity = best_capacity(size() + count);
-		pointer const newData = allocate(newCapacity);
+		const auto block = allocate_at_least(best_capacity(size() + count));
+		const size_type newCapacity = block.count;
+		pointer const newData = block.ptr;
 		
 		// Move the prefix from the old array...
 		pointer const newPosition = move_construct_from_range(newData, ibegin(), position);
@@ -1537,8 +1699,9 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::do_replace_range(poin
 		// Increasing the size.  By enough to require a reallocation?
 		const size_type insertSize = count - rangeSize;
 
-		if(!many(insertSize)) {
-			// Increasing the size, but not by enough to force a reallocation.
+		if(!many(insertSize) || resize_in_place(best_capacity(size() + insertSize))) {
+			// Increasing the size, but not by enough to force a reallocation (or the allocator grew
+			// the array in place).
 
 			// Now, move the suffix forward
 			pointer const ufirst = move_forward_n(last, insertSize);
@@ -1555,8 +1718,9 @@ inline typename vector<T,Alloc>::iterator vector<T,Alloc>::do_replace_range(poin
 			// we can skip moving the elements to be overwritten, since they're to be erased anyway.
 			// Allocate the best amount...
 			const size_type oldCapacity = capacity();
-			const size_type newCapacity = best_capacity(size() + insertSize);
-			const pointer newData = allocate(newCapacity);
+			const auto block = allocate_at_least(best_capacity(size() + insertSize));
+			const size_type newCapacity = block.count;
+			pointer const newData = block.ptr;
 
 			// Move the prefix over...
 			const pointer insertFirst = move_construct_from_range(newData, ibegin(), first);
@@ -1599,13 +1763,14 @@ template<typename T, typename Alloc>
 template<typename... Args>
 inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_internal(pointer position, Args&&... args) {
 	// If the container isn't full, we need to use the simple algorithm anyway, because the content
-	// we're moving in make_gap_1() may contain one of the params.
-	if(kane::use_simple_insert<T>::value || !full()) {
+	// we're moving in make_gap_1() may contain one of the params.  Same if the allocator can make 
+	// room by growing the array in place.
+	if(kane::use_simple_insert<T>::value || !full() || resize_in_place(next_capacity())) {
 		// Create a temporary (to solve the aliasing problem)
 		value_type temp(std::forward<Args>(args)...);
 		pointer const newPosition = make_gap_1(position);
 		// Select whether to use move-assignment or move-construction
-		if(value_has_trivial_destroy || newPosition != position) {
+		if(gap_uses_construct || newPosition != position) {
 			// newPosition is uninitialised (or has no-op destroy)
 			construct(newPosition, std::move(temp));
 		} else {
@@ -1618,8 +1783,9 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_internal(point
 		// We're using the complex algorithm and the container is full.  Avoid the copy by 
 		// doing partial reallocation.
 		// Get the new array.
-		const size_type newCapacity = next_capacity();
-		pointer const newData = allocate(newCapacity);
+		const auto block = allocate_at_least(next_capacity());
+		const size_type newCapacity = block.count;
+		pointer const newData = block.ptr;
 		// Calculate the new insert position based on the index in the old array
 		pointer const newPosition = newData + (position - ibegin());
 		// Emplace-construct
@@ -1638,7 +1804,8 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_internal(point
 template<typename T, typename Alloc>
 template<typename... Args>
 inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_back_internal(Args&&... args) {
-	if(!full()) {
+	// (Growing in place doesn't move anything, so args can't be invalidated.)
+	if(!full() || resize_in_place(next_capacity())) {
 		// Can just insert optimally at end
 		pointer const position = iend();
 		construct(position, std::forward<Args>(args)...);
@@ -1657,8 +1824,9 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_back_internal(
 
 	} else {
 		// Do partial reallocation.  Get the new array.
-		const size_type newCapacity = next_capacity();
-		pointer const newData = allocate(newCapacity);
+		const auto block = allocate_at_least(next_capacity());
+		const size_type newCapacity = block.count;
+		pointer const newData = block.ptr;
 		// Calculate the new insert position
 		pointer const newPosition = newData + size();
 		// Emplace-construct
@@ -1678,24 +1846,25 @@ template<typename T, typename Alloc>
 template<typename... Args>
 inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_n_internal(pointer const position, size_type count, Args&&... args) {
 	// If the container has enough capacity, we need to use the simple algorithm anyway, because 
-	// the content we're moving in make_gap_n() may contain one of the params.
-	if(kane::use_simple_insert<T>::value || few(count)) {
+	// the content we're moving in make_gap_n() may contain one of the params.  Same if the 
+	// allocator can make room by growing the array in place.
+	if(kane::use_simple_insert<T>::value || few(count) || resize_in_place(best_capacity(size() + count))) {
 		// Create a temporary (to solve the aliasing problem)
 		const value_type temp(std::forward<Args>(args)...);
 		// ranges.first is the start of the initialised segment, ranges.second is the start of the 
 		// uninitialised segment.  newPosition is the new location of the element at position
-		const std::pair<pointer, pointer> ranges = make_gap_n(position);
+		const std::pair<pointer, pointer> ranges = make_gap_n(position, count);
 		pointer const newPosition = ranges.first + count;
 		
-		// If value_has_trivial_destory, we can use copy construction for the whole range.
+		// If gap_uses_construct, we can use copy construction for the whole range.
 		// Otherwise, we need to split it up.
 		// TODO: Check if the compiler would optimise this without needing the test in this method
-		if(value_has_trivial_destroy) {
+		if(gap_uses_construct) {
 			construct_range(ranges.first, newPosition, temp);
 		} else {
-			// Copy construct the first range, copy assign the second range
-			construct_range(ranges.first, ranges.second, temp);
-			assign_range(ranges.second, newPosition, temp);
+			// Copy assign the initialised range, copy construct the uninitialised range
+			assign_range(ranges.first, ranges.second, temp);
+			construct_range(ranges.second, newPosition, temp);
 		}
 
 		return ranges.first;
@@ -1704,8 +1873,9 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_n_internal(poi
 		// We're using the complex algorithm and the container is full.  Avoid the copy by 
 		// doing partial reallocation.
 		// Get the new array.
-		const size_type newCapacity = best_capacity(size() + count);
-		pointer const newData = allocate(newCapacity);
+		const auto block = allocate_at_least(best_capacity(size() + count));
+		const size_type newCapacity = block.count;
+		pointer const newData = block.ptr;
 		// Calculate the new insert position based on the index in the old array
 		pointer const newPosition = newData + (position - ibegin());
 		// Emplace-construct an exemplar
@@ -1727,7 +1897,7 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_n_internal(poi
 template<typename T, typename Alloc>
 template<typename... Args>
 inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_back_n_internal(size_type count, Args&&... args) {
-	if(!full()) {
+	if(!full() || resize_in_place(best_capacity(size() + count))) {
 		// Emplace the exemplar element
 		emplace_back_internal(std::forward<Args>(args>)...);
 		// Reallocate if necessary for remaining elements
@@ -1751,8 +1921,9 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_back_n_interna
 	
 	} else {
 		// Do partial reallocation.  Get the new array.
-		const size_type newCapacity = best_capacity(size() + count);
-		pointer const newData = allocate(newCapacity);
+		const auto block = allocate_at_least(best_capacity(size() + count));
+		const size_type newCapacity = block.count;
+		pointer const newData = block.ptr;
 		// Calculate the new insert position
 		pointer const newPosition = newData + size();
 		// Emplace-construct exemplar
@@ -1774,13 +1945,13 @@ inline typename vector<T,Alloc>::pointer vector<T,Alloc>::emplace_back_n_interna
 template<typename T, typename Alloc>
 template<typename U, typename OtherAlloc>
 inline bool vector<T,Alloc>::operator==(const vector<U,OtherAlloc>& rhs) const {
-	return size() == rhs.size() && std::equal(ibegin(), iend(), rhs.ibegin());
+	return size() == rhs.size() && kane::unchecked_equal(ibegin(), iend(), rhs.ibegin());
 }
 
 template<typename T, typename Alloc>
 template<typename U, typename OtherAlloc>
 inline bool vector<T,Alloc>::operator!=(const vector<U,OtherAlloc>& rhs) const {
-	return size() != rhs.size() || !std::equal(ibegin(), iend(), rhs.ibegin());
+	return size() != rhs.size() || !kane::unchecked_equal(ibegin(), iend(), rhs.ibegin());
 }
 
 template<typename T, typename Alloc>
@@ -1822,17 +1993,102 @@ inline bool vector<T,Alloc>::operator>=(const vector<U,OtherAlloc>& rhs) const {
 template<typename T, typename Alloc>
 std::ostream& operator<<(std::ostream& stream, const vector<T,Alloc>& vec) {
 	typedef typename vector<T,Alloc>::const_pointer const_pointer;
-	stream << '[';
-	
-	if(!vec.empty()) {
-		const_pointer i = vec.ibegin();
-		const const_pointer e = vec.iend();
 
-		stream << *i;
-		while(++i != e) { stream << ' ' << *i; }
+	if constexpr(detail::is_to_chars_formattable<T>) {
+		// Format the lot, then one write() instead of a virtual call or two per element
+		vector<char> buffer;
+		buffer.push_back('[');
+		kane::format_to(buffer, vec, " ");
+		buffer.push_back(']');
+		return stream.write(buffer.data(), std::streamsize(buffer.size()));
+	} else {
+		stream << '[';
+
+		if(!vec.empty()) {
+			const_pointer i = vec.ibegin();
+			const const_pointer e = vec.iend();
+
+			stream << *i;
+			while(++i != e) { stream << ' ' << *i; }
+		}
+
+		return stream << ']';
+	}
+}
+
+template<typename CharAlloc, typename T, typename Alloc>
+inline vector<char, CharAlloc>& format_to(vector<char, CharAlloc>& buffer, const vector<T, Alloc>& vec, const std::string_view separator) {
+	return kane::format_to(buffer, vec.data(), vec.data() + vec.size(), separator);
+}
+
+template<typename CharAlloc, typename T>
+inline vector<char, CharAlloc>& format_to(vector<char, CharAlloc>& buffer, const T* first, const T* const last, const std::string_view separator) {
+	static_assert(detail::is_to_chars_formattable<T>, "kane::format_to() formats integers and floating-point numbers");
+	if(first == last) { return buffer; }
+
+	// Longest thing to_chars() can produce: sign and digits for integers; for floating-point
+	// numbers, the shortest form is never longer than scientific notation with max_digits10 
+	// significant digits, which is sign, digits, point, "e-" and the exponent (the biggest being
+	// the smallest denormal's)
+	constexpr std::size_t maxChars = std::is_floating_point<T>::value 
+		? 5 + std::size_t(std::numeric_limits<T>::max_digits10) + detail::decimal_digits(std::size_t(std::max(std::numeric_limits<T>::max_exponent10, 
+			std::numeric_limits<T>::max_digits10 - std::numeric_limits<T>::min_exponent10)))
+		: std::size_t(std::numeric_limits<T>::digits10) + 3;
+	const std::size_t needed = maxChars + separator.size();
+
+	// Each element is formatted straight into the buffer's spare capacity, and then resize() 
+	// takes it in (which, for chars, constructs nothing), so reserve enough for the first
+	// element plus a guess at the rest, growing geometrically from there
+	buffer.reserve(buffer.size() + needed + std::size_t(last - first) * 4);
+	for(bool firstElement = true; first != last; ++first, firstElement = false) {
+		if(buffer.available() < needed) { buffer.reserve(std::max(buffer.capacity() * 2, buffer.size() + needed)); }
+		char* p = buffer.data() + buffer.size();
+		if(!firstElement) {
+			std::memcpy(p, separator.data(), separator.size());
+			p += separator.size();
+		}
+		const std::to_chars_result result = std::to_chars(p, p + maxChars, *first);
+		_ASSERTE(result.ec == std::errc());
+		buffer.resize(std::size_t(result.ptr - buffer.data()));
+	}
+	return buffer;
+}
+
+template<typename T, typename Alloc>
+inline parse_result parse_into(vector<T, Alloc>& vec, const char* first, const char* const last, const std::string_view delimiters) {
+	static_assert(detail::is_to_chars_formattable<T>, "kane::parse_into() parses integers and floating-point numbers");
+	const detail::byte_set delimiterSet(delimiters.data(), delimiters.size());
+	const std::size_t initialSize = vec.size();
+
+	// Numbers are parsed straight into the spare capacity, and resize() takes them in at the end
+	// (or when it runs out), constructing nothing.  Guess one number per 8 characters to start
+	// with, so a big buffer doesn't reallocate its way up from nothing.
+	vec.reserve(vec.size() + std::size_t(last - first) / 8 + 16);
+	T* out = vec.data() + vec.size();
+	T* outEnd = vec.data() + vec.capacity();
+
+	std::errc ec = std::errc();
+	for(first = delimiterSet.find_first_not_in(first, last); first != last; first = delimiterSet.find_first_not_in(first, last)) {
+		if(out == outEnd) {
+			const std::size_t size = std::size_t(out - vec.data());
+			vec.resize(size);
+			vec.reserve(size * 2);
+			out = vec.data() + size;
+			outEnd = vec.data() + vec.capacity();
+		}
+
+		const char* const tokenEnd = delimiterSet.find_first_in(first, last);
+		const std::from_chars_result r = std::from_chars(first, tokenEnd, *out);
+		if(r.ec != std::errc() || r.ptr != tokenEnd) {
+			ec = r.ec != std::errc() ? r.ec : std::errc::invalid_argument;
+			break;
+		}
+		++out;
+		first = tokenEnd;
 	}
 
-	return stream << ']';
+	vec.resize(std::size_t(out - vec.data()));
+	return parse_result{ first, vec.size() - initialSize, ec };
 }
 
 // Construct a back inserter pointing to the "end" of any container
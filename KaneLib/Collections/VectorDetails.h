@@ -25,6 +25,7 @@
 
 #include <KaneLib/Collections/ContainerFwd.h>
 #include <KaneLib/Collections/ArrayContainerBase.h>
+#include <KaneLib/Collections/GrowthPolicy.h>
 
 namespace kane { namespace detail { 
 
@@ -92,9 +93,12 @@ public:
 	typedef typename alloc_base::size_type		  size_type;
 	typedef typename alloc_base::difference_type  difference_type;
 
-	// TODO: Make sure this actually works
-	static constexpr size_type first_capacity_increment = next_capacity(0);
-	static constexpr size_type second_capacity_increment = next_capacity(first_capacity_increment);
+	// Growth policy, as selected by kane::vector_growth_policy (see GrowthPolicy.h)
+	typedef typename kane::vector_growth_policy<T, Alloc>::type growth_policy;
+
+	// (These go straight to the policy, since next_capacity() isn't defined yet at this point.)
+	static constexpr size_type first_capacity_increment = growth_policy::next_capacity(0, sizeof(value_type));
+	static constexpr size_type second_capacity_increment = growth_policy::next_capacity(first_capacity_increment, sizeof(value_type));
 
 	///////////////////////////////////////////////////////////////////////////////////////////
 	// Traits for TMP
@@ -109,6 +113,12 @@ public:
 	//static constexpr bool alloc_propagate_swap = allocator_type_traits::propagate_on_container_swap();
 	//static constexpr bool alloc_is_always_equal = allocator_type_traits::is_always_equal();
 
+	// True if the gap left by make_gap_1()/make_gap_n() (and move_forward_1()/move_forward_n()) 
+	// should always be filled by construction.  Either destruction is a no-op, so construction is
+	// as good as assignment, or the elements were relocated out of the gap, leaving it 
+	// uninitialised.
+	static constexpr bool gap_uses_construct = alloc_base::value_has_trivial_destroy || alloc_base::value_has_trivial_relocate;
+
 	///////////////////////////////////////////////////////////////////////////////////////////////
 	// Constructors
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -123,6 +133,9 @@ public:
 	vector_base(const size_type sz);
 	// Construct empty vector with specified initial capacity and allocator
 	vector_base(const size_type sz, const Alloc& a);
+	// Construct vector of sz zero-filled elements, with memory from allocate_zeroed()
+	vector_base(const kane::zeroed_t, const size_type sz);
+	vector_base(const kane::zeroed_t, const size_type sz, const Alloc& a);
 	// Copy-construct from another vector, using a copy of other vector's allocator
 	vector_base(const vector_base& other);
 	// Copy-construct from another vector, using specified allocator
@@ -220,7 +233,8 @@ public:
 	// Creates a gap of size 1.  Return value is the same as position if no allocation was required,
 	// otherwise a pointer into the new array.  If no allocation was required, the return value 
 	// points to an initialised element, otherwise it points to an uninitialised element.
-	// (So, if result == position, use assignment, otherwise use construction.)
+	// (So, if result == position, use assignment, otherwise use construction.  Unless 
+	// gap_uses_construct, in which case always use construction.)
 	pointer make_gap_1(pointer const position);
 
 	// Creates a gap of size N.  Return value is a pair of pointers to the initialised and 
@@ -231,13 +245,19 @@ public:
 	///////////////////////////////////////////////////////////////////////////////////////////////
 	// Vector Operations
 	///////////////////////////////////////////////////////////////////////////////////////////////
-	// Determines the next capacity (currently, 2 if capacity == 0, otherwise capacity * 2).
+	// Determines the next capacity, as chosen by the growth policy (by default, 2 if capacity == 0,
+	// otherwise capacity * 2).
 	size_type next_capacity() const;
 	// Next capacity increment given the specified current capacity.
-	constexpr size_type next_capacity(const size_type sz);
+	static constexpr size_type next_capacity(const size_type sz);
 	// Determines the best next capacity large enough to contain the specified size.
-	// Currently, this is the larger of needed and next_capacity()
+	// This is the larger of needed and next_capacity(), rounded by the growth policy.
 	size_type best_capacity(const size_type needed) const;
+	// Clamps a capacity chosen by the growth policy to max_size(), so long as that leaves room for
+	// needed, if the allocator can grow arrays in place.  Otherwise, the last growth step of a 
+	// vector using reserved_allocator would ask for more than its reservation and fail, with up 
+	// to half of the reservation left.
+	size_type clamp_capacity(const size_type newCapacity, const size_type needed) const;
 
 	// Reallocate the internal array to the next_capacity()
 	void reallocate();
@@ -247,6 +267,9 @@ public:
 	// (No sanity checks are performed on the inputs.  This should normally only be called from 
 	// inside reallocate().  At the very least, requires 0 <= oldCapacity < newCapacity.)
 	void really_reallocate(const size_type oldCapacity, const size_type newCapacity);
+	// Try to resize the internal array to the specified capacity without moving it, using the 
+	// allocator's try_expand().  Always fails if there's no array or the allocator can't do it.
+	bool resize_in_place(const size_type newCapacity);
 
 	///////////////////////////////////////////////////////
 	// InputIterator Helper
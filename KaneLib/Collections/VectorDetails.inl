@@ -25,7 +25,8 @@ template<typename T, typename Alloc>
 inline vector_base<T,Alloc>::vector_base(const size_type sz) 
 	: members_base(kane::no_default_construct), alloc_base() { 
 	if(sz > 0) {
-		reset( allocate(sz), sz );
+		const auto block = allocate_at_least(sz);
+		reset( block.ptr, block.count );
 	} else {
 		reset();
 	}
@@ -36,7 +37,33 @@ template<typename T, typename Alloc>
 inline vector_base<T,Alloc>::vector_base(const size_type sz, const Alloc& a) 
 	: members_base(kane::no_default_construct), alloc_base(a) { 
 	if(sz > 0) {
-		reset( allocate(sz), sz );
+		const auto block = allocate_at_least(sz);
+		reset( block.ptr, block.count );
+	} else {
+		reset();
+	}
+}
+
+// Construct vector of sz zero-filled elements with default-constructed allocator.  The elements 
+// aren't constructed, so this is only for value_types that are trivially copyable.
+template<typename T, typename Alloc>
+inline vector_base<T,Alloc>::vector_base(const kane::zeroed_t, const size_type sz) 
+	: members_base(kane::no_default_construct), alloc_base() { 
+	if(sz > 0) {
+		const auto block = allocate_zeroed(sz);
+		reset( block.ptr, block.ptr + sz, block.count );
+	} else {
+		reset();
+	}
+}
+
+// Construct vector of sz zero-filled elements with specified allocator
+template<typename T, typename Alloc>
+inline vector_base<T,Alloc>::vector_base(const kane::zeroed_t, const size_type sz, const Alloc& a) 
+	: members_base(kane::no_default_construct), alloc_base(a) { 
+	if(sz > 0) {
+		const auto block = allocate_zeroed(sz);
+		reset( block.ptr, block.ptr + sz, block.count );
 	} else {
 		reset();
 	}
@@ -49,9 +76,9 @@ inline vector_base<T,Alloc>::vector_base(const vector_base& other)
 
 	const size_type otherSize = other.size();
 	if(otherSize) {
-		pointer const newData = allocate(otherSize);
-		pointer const newSize = copy_construct_from_range(newData, other.ibegin(), other.iend());
-		reset(newData, newSize, newSize);
+		const auto block = allocate_at_least(otherSize);
+		pointer const newSize = copy_to_new_array(block.ptr, other.ibegin(), other.iend());
+		reset(block.ptr, newSize, block.count);
 	} else {
 		reset();
 	}
@@ -64,9 +91,9 @@ inline vector_base<T,Alloc>::vector_base(const vector_base& other, const Alloc&
 
 	const size_type otherSize = other.size();
 	if(otherSize) {
-		pointer const newData = allocate(otherSize);
-		pointer const newSize = copy_construct_from_range(newData, other.ibegin(), other.iend());
-		reset(newData, newSize, newSize);
+		const auto block = allocate_at_least(otherSize);
+		pointer const newSize = copy_to_new_array(block.ptr, other.ibegin(), other.iend());
+		reset(block.ptr, newSize, block.count);
 	} else {
 		reset();
 	}
@@ -210,27 +237,33 @@ inline bool vector_base<T,Alloc>::few(const size_type sz) const { return (size()
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Vector Operations
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-// Determines the next capacity (currently, (m_capacity * 2, or 2 on first allocation).
+// Determines the next capacity from the current capacity.
 template<typename T, typename Alloc> 
 inline typename vector_base<T,Alloc>::size_type vector_base<T,Alloc>::next_capacity() const { 
-	return next_capacity(capacity());
+	return clamp_capacity(next_capacity(capacity()), capacity() + 1);
 }
 
-// Determines the next capacity (currently, (sz * 2, or 2 on first allocation).
+// Determines the next capacity from sz, according to the growth policy.
 template<typename T, typename Alloc>
 inline constexpr typename vector_base<T,Alloc>::size_type vector_base<T,Alloc>::next_capacity(const size_type sz) {
-	// Huh, compiler implements this as "add eax,eax."  Surprising that add reg,reg is faster than 
-	// shl reg/imm...
-	return sz ? (sz * 2) : 2;
-	// (Roughly) MSVC's resize factor, for performance comparisons
-	//return sz / 2 + sz + 1;
+	return size_type(growth_policy::next_capacity(sz, sizeof(value_type)));
 }
 
 // Determines the best next capacity large enough to contain the specified size.
-// Currently, this is the larger of needed and next_capacity()
+// This is the larger of needed and next_capacity(), rounded up to whatever the growth policy 
+// prefers (a whole number of pages, say).
 template<typename T, typename Alloc> 
 inline typename vector_base<T,Alloc>::size_type vector_base<T,Alloc>::best_capacity(const size_type needed) const {
-	return std::max(needed, next_capacity());
+	return clamp_capacity(size_type(growth_policy::round_capacity(std::max(needed, next_capacity()), sizeof(value_type))), needed);
+}
+
+template<typename T, typename Alloc> 
+inline typename vector_base<T,Alloc>::size_type vector_base<T,Alloc>::clamp_capacity(const size_type newCapacity, const size_type needed) const {
+	if constexpr(alloc_can_expand) {
+		const size_type limit = size_type(this->max_size());
+		if(newCapacity > limit) { return std::max(limit, needed); }
+	}
+	return newCapacity;
 }
 
 // Reallocate the internal array to the next_capacity()
@@ -251,25 +284,55 @@ inline void vector_base<T,Alloc>::reallocate(const size_type newCapacity) {
 // oldCapacity < newCapacity and newCapacity != 0.
 template<typename T, typename Alloc> 
 inline void vector_base<T,Alloc>::really_reallocate(const size_type oldCapacity, const size_type newCapacity) {
-	// Allocate new array...
-	pointer const newData = allocate(newCapacity);
+	if(m_data) {
+		// If the allocator can grow the current array in place, nothing needs to move at all
+		if(resize_in_place(newCapacity)) { return; }
+
+		// Otherwise, if the elements can be relocated bytewise, let the allocator do it.  It may
+		// be able to remap pages rather than copying (glibc's realloc() uses mremap() for large 
+		// blocks, for instance).
+		if constexpr(alloc_can_reallocate && value_has_trivial_relocate) {
+			const size_type oldSize = size();
+			pointer const newData = reallocate_array(m_data, oldCapacity, newCapacity);
+			reset(newData, newData + oldSize, newCapacity);
+			return;
+		}
+	}
+
+	// Allocate new array, taking whatever extra capacity the allocator gives us...
+	const auto block = allocate_at_least(newCapacity);
+	pointer const newData = block.ptr;
 	pointer newSize = newData;
 
-	// If the current array is non-empty, move the old elements into the new array and erase 
-	// the old elements.  Note that we still have to destroy moved elements.
-	// move_construct_from_range() and destroy() both have the same first != last check at the front,
-	// so we don't need to check if it's empty first.  But we DO have to test for m_data to figure
-	// out if we're deallocating, so might as well do that here.
+	// If the current array is non-empty, relocate the old elements into the new array.  (That's
+	// a move followed by destroying the moved elements, or a single memmove for trivially 
+	// relocatable types, or a streaming copy if there are enough of them to flush the cache.)
+	// relocate_to_new_array() has the same first != last check at the front, so we don't need to 
+	// check if it's empty first.  But we DO have to test for m_data to figure out if we're 
+	// deallocating, so might as well do that here.
 	// (Note that deallocate() is not the same as delete, and therefore doesn't have to follow the
 	// same rule that it does nothing to a NULL pointer.)
 	if(m_data) {
-		newSize = move_construct_from_range(newSize, ibegin(), iend());
-		destroy(ibegin(), iend());
+		newSize = relocate_to_new_array(newSize, ibegin(), iend());
 		deallocate(m_data, oldCapacity);
 	}
 
 	// Finally, set the new array
-	reset(newData, newSize, newCapacity);
+	reset(newData, newSize, block.count);
+}
+
+// Resize the current array without moving it, if the allocator can.  This is how allocators like
+// reserved_allocator keep the elements' addresses stable as the vector grows, so every growth path
+// that would otherwise move the elements should try this first.
+template<typename T, typename Alloc> 
+inline bool vector_base<T,Alloc>::resize_in_place(const size_type newCapacity) {
+	if constexpr(alloc_can_expand) {
+		if(m_data && try_expand(m_data, capacity(), newCapacity)) {
+			reset(m_data, m_size, newCapacity);
+			return true;
+		}
+	}
+	return false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -286,7 +349,12 @@ inline void vector_base<T,Alloc>::move_forward_1(pointer const position) {
 	_ASSERTE(position != iend());
 	pointer dest = iend();
 
-	if(value_has_trivial_destroy) {
+	if constexpr(value_has_trivial_relocate) {
+		// Trivially relocatable, so shift the whole block up with a single memmove.  This leaves 
+		// the element at position uninitialised (see gap_uses_construct).
+		bulk_copy_n(position + 1, position, size_type(dest - position));
+
+	} else if(value_has_trivial_destroy) {
 		// Move everything using move construction if move-construct == move-assign
 		while(dest != position) {
 			pointer const src = dest - 1;
@@ -327,7 +395,14 @@ inline typename vector_base<T,Alloc>::pointer vector_base<T,Alloc>::move_forward
 	pointer dest = src + sz;
 	iend(dest);
 
-	if(value_has_trivial_destroy) {
+	if constexpr(value_has_trivial_relocate) {
+		// Trivially relocatable, so shift the whole block up with a single memmove.  The elements 
+		// were relocated out of the gap, so the whole gap is uninitialised and the initialised 
+		// segment is empty.
+		bulk_copy_n(position + sz, position, size_type(last - position));
+		return position;
+
+	} else if(value_has_trivial_destroy) {
 		while(src != position) {
 			--src;
 			--dest;
@@ -378,18 +453,17 @@ inline typename vector_base<T,Alloc>::pointer vector_base<T,Alloc>::move_forward
 
 template<typename T, typename Alloc>
 inline typename vector_base<T,Alloc>::pointer vector_base<T,Alloc>::make_gap_1(pointer const position) {
-	if(full()) {
+	if(full() && !resize_in_place(next_capacity())) {
 		const size_type oldCapacity = capacity();
-		const size_type newCapacity = next_capacity();
-		pointer const newData = allocate(newCapacity);
+		const auto block = allocate_at_least(next_capacity());
+		pointer const newData = block.ptr;
 
-		pointer const newPosition = move_construct_from_range(newData, ibegin(), position);
-		pointer const newSize = move_construct_from_range(newPosition + 1, position, iend());
+		pointer const newPosition = relocate_from_range(newData, ibegin(), position);
+		pointer const newSize = relocate_from_range(newPosition + 1, position, iend());
 
-		destroy(ibegin(), iend());
 		deallocate(m_data, oldCapacity);
 
-		reset(newData, newSize, newCapacity);
+		reset(newData, newSize, block.count);
 		return newPosition;
 
 	} else {
@@ -402,17 +476,17 @@ template<typename T, typename Alloc>
 inline std::pair<typename vector_base<T,Alloc>::pointer, typename vector_base<T,Alloc>::pointer>
 vector_base<T,Alloc>::make_gap_n(pointer const position, const size_type sz) {
 	const size_type oldCapacity = capacity();
-	if((size() + sz) > oldCapacity) {
-		const size_type newCapacity = next_capacity(size() + sz);
-		pointer const newData = allocate(newCapacity);
+	const size_type newCapacity = clamp_capacity(next_capacity(size() + sz), size() + sz);
+	if((size() + sz) > oldCapacity && !resize_in_place(newCapacity)) {
+		const auto block = allocate_at_least(newCapacity);
+		pointer const newData = block.ptr;
 
-		pointer const newPosition = move_construct_from_range(newData, ibegin(), position);
-		pointer const newSize = move_construct_from_range(newPosition + sz, position, iend());
+		pointer const newPosition = relocate_from_range(newData, ibegin(), position);
+		pointer const newSize = relocate_from_range(newPosition + sz, position, iend());
 
-		destroy(ibegin(), iend());
 		deallocate(m_data, oldCapacity);
 
-		reset(newData, newSize, newCapacity);
+		reset(newData, newSize, block.count);
 		return std::make_pair(newPosition, newPosition);
 
 	} else {
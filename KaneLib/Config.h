@@ -16,4 +16,32 @@
 #endif
 
 // Windows.h is so horrible, so horrible
-#define NOMINMAX
\ No newline at end of file
+#define NOMINMAX
+
+// Size of a cache line, for keeping data written by different threads apart.  64 bytes is right
+// for every x86 and most ARM chips worth caring about.
+#ifndef KANELIB_CACHE_LINE_SIZE
+#define KANELIB_CACHE_LINE_SIZE 64
+#endif
+
+// SIMD instruction sets available at compile time, going by the compiler's own target macros 
+// (/arch on MSVC, -m flags elsewhere).  Each implies the ones below it.  Define KANELIB_NO_SIMD to 
+// use only scalar code.
+#ifndef KANELIB_NO_SIMD
+#if defined(__AVX512F__)
+#define KANELIB_AVX512 1
+#endif
+#if defined(__AVX2__)
+#define KANELIB_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KANELIB_SSE2 1
+#endif
+#endif
+
+// Size in bytes above which bulk memory operations use non-temporal (streaming) stores, which 
+// bypass the cache instead of evicting everything else from it.  Should be somewhere around the
+// size of the last-level cache.
+#ifndef KANELIB_STREAMING_THRESHOLD
+#define KANELIB_STREAMING_THRESHOLD (std::size_t(8) << 20)
+#endif
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                       //////// huge_page_allocator<T> ////////                     ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// An allocator that puts large blocks on huge pages.  Random access into a multi-gigabyte array
+// on 4KB pages misses the TLB on nearly every access; with 2MB pages, the same array needs 512
+// times fewer TLB entries.
+//
+// Blocks of at least the threshold size (2MB by default) are mapped directly from the OS, aligned
+// to a huge page boundary and rounded up to a whole number of huge pages, then marked as wanting
+// huge pages (see detail::vm::map_huge() in VirtualMemory.h).  If the OS won't provide them
+// (transparent huge pages disabled, no large page privilege on Windows), the block is still
+// perfectly usable, just on ordinary pages.  Smaller blocks come from std::allocator as usual.
+//
+// allocate_at_least() reports the whole huge-page-rounded size, so a vector using this allocator
+// gets the rounding as free capacity.  Huge-page blocks come straight from the OS, so they're
+// zeroed, and allocate_zeroed() only has to clear small blocks.
+#pragma once
+
+#include <KaneLib/Config.h>
+#include <KaneLib/Utility/Utility.h>
+#include <KaneLib/Memory/VirtualMemory.h>
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace kane {
+
+template<typename T>
+class huge_page_allocator {
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef T			   value_type;
+	typedef T*			   pointer;
+	typedef const T*	   const_pointer;
+	typedef std::size_t	   size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	typedef std::true_type  propagate_on_container_copy_assignment;
+	typedef std::true_type  propagate_on_container_move_assignment;
+	typedef std::true_type  propagate_on_container_swap;
+	typedef std::false_type is_always_equal;
+
+	template<typename U> struct rebind { typedef huge_page_allocator<U> other; };
+
+	// Default size, in bytes, from which blocks go on huge pages
+	static constexpr std::size_t default_threshold = KANELIB_HUGE_PAGE_SIZE;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	explicit huge_page_allocator(const std::size_t thresholdBytes = default_threshold) noexcept
+		: m_threshold(thresholdBytes) { }
+	template<typename U>
+	huge_page_allocator(const huge_page_allocator<U>& other) noexcept : m_threshold(other.threshold()) { }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Allocation
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	pointer allocate(const size_type n) { return allocate_at_least(n).ptr; }
+
+	kane::allocation_result<pointer, size_type> allocate_at_least(const size_type n) {
+		if(n > max_size()) { throw std::bad_array_new_length(); }
+
+		const std::size_t bytes = n * sizeof(T);
+		if(bytes < m_threshold) { return { std::allocator<T>().allocate(n), n }; }
+
+		const std::size_t mapped = detail::vm::round_up(bytes, KANELIB_HUGE_PAGE_SIZE);
+		void* const p = detail::vm::map_huge(mapped);
+		if(!p) { throw std::bad_alloc(); }
+		return { static_cast<pointer>(p), mapped / sizeof(T) };
+	}
+
+	// Only small blocks need clearing; mappings come zeroed from the OS
+	kane::allocation_result<pointer, size_type> allocate_zeroed(const size_type n) {
+		const auto block = allocate_at_least(n);
+		if(n * sizeof(T) < m_threshold) { std::memset(static_cast<void*>(block.ptr), 0, n * sizeof(T)); }
+		return block;
+	}
+
+	// (Any count between the requested one and the one allocate_at_least() returned rounds to the
+	// same mapping size.)
+	void deallocate(pointer const p, const size_type n) noexcept {
+		const std::size_t bytes = n * sizeof(T);
+		if(bytes < m_threshold) {
+			std::allocator<T>().deallocate(p, n);
+		} else {
+			detail::vm::release(p, detail::vm::round_up(bytes, KANELIB_HUGE_PAGE_SIZE));
+		}
+	}
+
+	size_type max_size() const noexcept { return (std::numeric_limits<size_type>::max() - KANELIB_HUGE_PAGE_SIZE) / sizeof(T); }
+
+	// Size, in bytes, from which blocks go on huge pages
+	std::size_t threshold() const noexcept { return m_threshold; }
+
+private:
+	std::size_t m_threshold;
+};
+
+// Allocators with the same threshold can deallocate each other's blocks
+template<typename T, typename U>
+inline bool operator==(const huge_page_allocator<T>& lhs, const huge_page_allocator<U>& rhs) noexcept { return lhs.threshold() == rhs.threshold(); }
+template<typename T, typename U>
+inline bool operator!=(const huge_page_allocator<T>& lhs, const huge_page_allocator<U>& rhs) noexcept { return lhs.threshold() != rhs.threshold(); }
+
+}
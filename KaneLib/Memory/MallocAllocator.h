@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                        //////// malloc_allocator<T> ////////                      ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A stateless allocator that gets its memory straight from malloc() and friends, rather than
+// operator new.  The point of going to the C allocator is that it can do things operator new
+// can't: it provides the optional allocator extensions array containers look for (see
+// ContainerFwd.h), so a kane::vector using malloc_allocator can grow its array in place, or let
+// realloc() move it for trivially relocatable value_types.  On glibc, realloc() of a large block
+// uses mremap(), so growing a multi-gigabyte vector is a page table update rather than a copy.
+//
+// try_expand() is only available on MSVC, which provides _expand().  glibc has no equivalent, so
+// elsewhere we only get reallocate().
+//
+// allocate_at_least() asks the C library how big the block it handed back really is (_msize() on
+// MSVC, malloc_size() on macOS) and reports all of it, so a vector's capacity covers the slack at
+// the end of the size class rather than reallocating early.  It's left out everywhere else,
+// including glibc: malloc_usable_size() is only meant for diagnostics there, and writing past the
+// requested size without realloc()ing first isn't supported (and _FORTIFY_SOURCE=3 can catch it).
+//
+// allocate_zeroed() uses calloc(), which gets large blocks straight from the OS already zeroed, so
+// a vector constructed with kane::zeroed doesn't write to any of its pages until it uses them.
+//
+// malloc() only guarantees alignment suitable for max_align_t, so over-aligned types aren't
+// supported.
+#pragma once
+
+#include <KaneLib/Config.h>
+#include <KaneLib/Utility/Utility.h>
+
+#include <cstdlib>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define KANELIB_MALLOC_USABLE_SIZE(p) _msize(p)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define KANELIB_MALLOC_USABLE_SIZE(p) malloc_size(p)
+#endif
+
+namespace kane {
+
+template<typename T>
+class malloc_allocator {
+public:
+	static_assert(alignof(T) <= alignof(std::max_align_t), "malloc_allocator doesn't support over-aligned types");
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef T			   value_type;
+	typedef T*			   pointer;
+	typedef const T*	   const_pointer;
+	typedef std::size_t	   size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	// Stateless, so everything propagates and all instances are equal
+	typedef std::true_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+	typedef std::true_type is_always_equal;
+
+	template<typename U> struct rebind { typedef malloc_allocator<U> other; };
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	malloc_allocator() noexcept { }
+	malloc_allocator(const malloc_allocator&) noexcept = default;
+	template<typename U> malloc_allocator(const malloc_allocator<U>&) noexcept { }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Allocation
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	pointer allocate(const size_type n) {
+		void* const p = std::malloc(bytes(n));
+		if(!p) { throw std::bad_alloc(); }
+		return static_cast<pointer>(p);
+	}
+
+#ifdef KANELIB_MALLOC_USABLE_SIZE
+	// Allocate at least n elements, reporting however many actually fit in the block
+	allocation_result<pointer, size_type> allocate_at_least(const size_type n) {
+		pointer const p = allocate(n);
+		return { p, size_type(KANELIB_MALLOC_USABLE_SIZE(p)) / sizeof(T) };
+	}
+#endif
+
+	// Allocate at least n elements with all bytes zero
+	allocation_result<pointer, size_type> allocate_zeroed(const size_type n) {
+		// (calloc() checks n * sizeof(T) for overflow itself)
+		void* const p = std::calloc(n, sizeof(T));
+		if(!p) { throw std::bad_alloc(); }
+#ifdef KANELIB_MALLOC_USABLE_SIZE
+		return { static_cast<pointer>(p), size_type(KANELIB_MALLOC_USABLE_SIZE(p)) / sizeof(T) };
+#else
+		return { static_cast<pointer>(p), n };
+#endif
+	}
+
+	void deallocate(pointer const p, size_type) noexcept { std::free(p); }
+
+	size_type max_size() const noexcept { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Extensions
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Resize the block, moving its bytes if realloc() decides to.  The old block is untouched if
+	// this throws.
+	pointer reallocate(pointer const p, size_type, const size_type newCount) {
+		void* const result = std::realloc(p, bytes(newCount));
+		if(!result) { throw std::bad_alloc(); }
+		return static_cast<pointer>(result);
+	}
+
+#ifdef _MSC_VER
+	// Try to grow (or shrink) the block without moving it
+	bool try_expand(pointer const p, size_type, const size_type newCount) noexcept {
+		if(newCount > max_size()) { return false; }
+		return _expand(p, newCount * sizeof(T)) != NULL;
+	}
+#endif
+
+private:
+	// Convert a count to a byte size, checking for overflow
+	size_type bytes(const size_type n) const {
+		if(n > max_size()) { throw std::bad_array_new_length(); }
+		return n * sizeof(T);
+	}
+};
+
+template<typename T, typename U>
+inline bool operator==(const malloc_allocator<T>&, const malloc_allocator<U>&) noexcept { return true; }
+template<typename T, typename U>
+inline bool operator!=(const malloc_allocator<T>&, const malloc_allocator<U>&) noexcept { return false; }
+
+}
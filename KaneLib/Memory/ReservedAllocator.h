@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                       //////// reserved_allocator<T> ////////                      ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// An allocator that reserves a large range of address space for every block, and only commits
+// pages as the block grows into them.  Reserving address space costs nothing but a page table
+// entry or two, so the default reservation is a generous 64GB (1GB on 32-bit platforms, which
+// only have 2-4GB of address space in all); pass a different size to the constructor if that's
+// not enough.
+//
+// The point is try_expand() (see ContainerFwd.h): growing a block just commits more pages of its
+// reservation, so it never fails until the reservation runs out.  A kane::vector using this
+// allocator grows in place, so it never copies its elements on the way up (no stalls, no 2x peak
+// memory while old and new arrays coexist), and pointers, references and iterators to its elements
+// stay valid across push_back() and friends.  See kane::reserved_vector in ReservedVector.h.
+//
+// Shrinking a block decommits the pages beyond its new end, again without moving it.
+//
+// Blocks are committed in whole pages, and allocate_at_least() reports the whole committed size,
+// so small allocations are wasteful.  Use this for a few very large containers, not many small
+// ones.
+//
+// Freshly committed pages are zeroed by the OS, so allocate_zeroed() is just allocate_at_least(),
+// and try_expand_zeroed() only has to clear the end of the block's last old page: either way, the
+// new pages stay untouched until they're written.
+//
+// Uses mmap()/mprotect() on POSIX platforms, and VirtualAlloc()/VirtualFree() on Windows.
+#pragma once
+
+#include <KaneLib/Config.h>
+#include <KaneLib/Utility/Utility.h>
+#include <KaneLib/Memory/VirtualMemory.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace kane {
+
+template<typename T>
+class reserved_allocator {
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Typedefs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	typedef T			   value_type;
+	typedef T*			   pointer;
+	typedef const T*	   const_pointer;
+	typedef std::size_t	   size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	typedef std::true_type  propagate_on_container_copy_assignment;
+	typedef std::true_type  propagate_on_container_move_assignment;
+	typedef std::true_type  propagate_on_container_swap;
+	typedef std::false_type is_always_equal;
+
+	template<typename U> struct rebind { typedef reserved_allocator<U> other; };
+
+	// Default size of each block's reservation, in bytes
+	static constexpr std::size_t default_reservation = std::size_t(1) << (sizeof(std::size_t) >= 8 ? 36 : 30);
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	explicit reserved_allocator(const std::size_t reservationBytes = default_reservation) noexcept
+		: m_reservation(detail::vm::round_to_pages(reservationBytes)) { }
+	template<typename U>
+	reserved_allocator(const reserved_allocator<U>& other) noexcept : m_reservation(other.reservation()) { }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Allocation
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	pointer allocate(const size_type n) { return allocate_at_least(n).ptr; }
+
+	// Reserve a new range, and commit enough of it for n elements
+	kane::allocation_result<pointer, size_type> allocate_at_least(const size_type n) {
+		if(n > max_size()) { throw std::bad_alloc(); }
+
+		void* const p = detail::vm::reserve(m_reservation);
+		if(!p) { throw std::bad_alloc(); }
+
+		const std::size_t committed = detail::vm::round_to_pages(n * sizeof(T));
+		if(!detail::vm::commit(p, committed)) {
+			detail::vm::release(p, m_reservation);
+			throw std::bad_alloc();
+		}
+
+		return { static_cast<pointer>(p), committed / sizeof(T) };
+	}
+
+	// Fresh reservations are always zeroed
+	kane::allocation_result<pointer, size_type> allocate_zeroed(const size_type n) { return allocate_at_least(n); }
+
+	void deallocate(pointer const p, size_type) noexcept { detail::vm::release(p, m_reservation); }
+
+	size_type max_size() const noexcept { return m_reservation / sizeof(T); }
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Extensions
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Commit or decommit pages at the end of the block.  Only fails when growing beyond the
+	// reservation, or if the OS refuses to commit the pages.
+	bool try_expand(pointer const p, const size_type oldCount, const size_type newCount) noexcept {
+		if(newCount > max_size()) { return false; }
+
+		char* const base = reinterpret_cast<char*>(p);
+		const std::size_t oldEnd = detail::vm::round_to_pages(oldCount * sizeof(T));
+		const std::size_t newEnd = detail::vm::round_to_pages(newCount * sizeof(T));
+
+		if(newEnd > oldEnd) {
+			return detail::vm::commit(base + oldEnd, newEnd - oldEnd);
+		} else {
+			detail::vm::decommit(base + newEnd, oldEnd - newEnd);
+			return true;
+		}
+	}
+
+	// Grow the block like try_expand(), with the new elements zeroed.  Pages committed now are
+	// fresh from the OS (decommitting maps new ones over the old), so only the bytes between the
+	// old end and the end of its page, which may hold anything, need clearing.
+	bool try_expand_zeroed(pointer const p, const size_type oldCount, const size_type newCount) noexcept {
+		_ASSERTE(newCount >= oldCount);
+		if(!try_expand(p, oldCount, newCount)) { return false; }
+
+		char* const oldEnd = reinterpret_cast<char*>(p + oldCount);
+		const std::size_t committedEnd = detail::vm::round_to_pages(oldCount * sizeof(T));
+		std::memset(oldEnd, 0, std::min(committedEnd, newCount * sizeof(T)) - oldCount * sizeof(T));
+		return true;
+	}
+
+	// Size of each block's reservation, in bytes
+	std::size_t reservation() const noexcept { return m_reservation; }
+
+private:
+	std::size_t m_reservation;
+};
+
+// Allocators with the same reservation size can release each other's blocks
+template<typename T, typename U>
+inline bool operator==(const reserved_allocator<T>& lhs, const reserved_allocator<U>& rhs) noexcept { return lhs.reservation() == rhs.reservation(); }
+template<typename T, typename U>
+inline bool operator!=(const reserved_allocator<T>& lhs, const reserved_allocator<U>& rhs) noexcept { return lhs.reservation() != rhs.reservation(); }
+
+}
@@ -0,0 +1,229 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Virtual memory primitives
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Thin wrappers over the platform's virtual memory API (mmap() and friends on POSIX platforms,
+// VirtualAlloc() and friends on Windows), shared by the allocators that go straight to the OS and
+// by kane::mapped_vector.
+// Sizes passed to the commit and decommit functions must be multiples of page_size(), and
+// addresses page-aligned.
+#pragma once
+
+#include <KaneLib/Config.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Size of a (transparent) huge page.  2MB on x86-64 and on ARM64 with 4KB base pages.
+#ifndef KANELIB_HUGE_PAGE_SIZE
+#define KANELIB_HUGE_PAGE_SIZE (std::size_t(2) << 20)
+#endif
+
+namespace kane { namespace detail { namespace vm {
+
+#ifndef _WIN32
+// Flags for mapping reserved pages.  MAP_NORESERVE keeps Linux from counting the whole
+// reservation against the overcommit limit, where that's a thing.
+#ifdef MAP_NORESERVE
+static constexpr int reserve_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+#else
+static constexpr int reserve_flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#endif
+#endif
+
+///////////////////////////////////////
+// Page sizes
+///////////////////////////////////////
+// Size of a page
+inline std::size_t page_size() noexcept {
+	static const std::size_t size = [] {
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return std::size_t(info.dwPageSize);
+#else
+		return std::size_t(sysconf(_SC_PAGESIZE));
+#endif
+	}();
+	return size;
+}
+
+// Round bytes up to a multiple of alignment, which must be a power of two
+inline std::size_t round_up(const std::size_t bytes, const std::size_t alignment) noexcept {
+	return (bytes + alignment - 1) & ~(alignment - 1);
+}
+
+// Round bytes up to a whole number of pages
+inline std::size_t round_to_pages(const std::size_t bytes) noexcept { return round_up(bytes, page_size()); }
+
+///////////////////////////////////////
+// Reserve and commit
+///////////////////////////////////////
+// Reserve an inaccessible range of address space.  Returns NULL on failure.
+inline void* reserve(const std::size_t bytes) noexcept {
+#ifdef _WIN32
+	return VirtualAlloc(NULL, bytes, MEM_RESERVE, PAGE_NOACCESS);
+#else
+	void* const p = mmap(NULL, bytes, PROT_NONE, reserve_flags, -1, 0);
+	return (p == MAP_FAILED) ? NULL : p;
+#endif
+}
+
+// Release a whole reservation (or mapping)
+inline void release(void* const p, const std::size_t bytes) noexcept {
+#ifdef _WIN32
+	(void)bytes;
+	VirtualFree(p, 0, MEM_RELEASE);
+#else
+	munmap(p, bytes);
+#endif
+}
+
+// Make part of a reservation readable and writable.  Returns false on failure.
+inline bool commit(void* const p, const std::size_t bytes) noexcept {
+	if(bytes == 0) { return true; }
+#ifdef _WIN32
+	return VirtualAlloc(p, bytes, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+	return mprotect(p, bytes, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+// Return part of a reservation's pages to the OS, leaving it reserved but inaccessible
+inline void decommit(void* const p, const std::size_t bytes) noexcept {
+	if(bytes == 0) { return; }
+#ifdef _WIN32
+	VirtualFree(p, bytes, MEM_DECOMMIT);
+#else
+	// Mapping fresh inaccessible pages over the top discards the old ones in one go
+	mmap(p, bytes, PROT_NONE, reserve_flags | MAP_FIXED, -1, 0);
+#endif
+}
+
+///////////////////////////////////////
+// Huge pages
+///////////////////////////////////////
+// Map bytes (a multiple of KANELIB_HUGE_PAGE_SIZE) of readable, writable, zeroed memory, aligned
+// to a huge page boundary and backed by huge pages if the OS is willing.  Returns NULL on failure.
+// Release with release(p, bytes).
+//
+// On Linux, the mapping is over-allocated by a huge page so an aligned range can be trimmed out
+// of it, and then marked with madvise(MADV_HUGEPAGE).  If transparent huge pages are disabled,
+// madvise() fails and we just have ordinary pages.
+//
+// On Windows, large pages need the "Lock pages in memory" privilege, so if VirtualAlloc() with
+// MEM_LARGE_PAGES fails, we fall back on an ordinary commit.  (Alignment doesn't matter without
+// large pages.)
+inline void* map_huge(const std::size_t bytes) noexcept {
+	const std::size_t huge = KANELIB_HUGE_PAGE_SIZE;
+#ifdef _WIN32
+	const std::size_t largeMinimum = GetLargePageMinimum();
+	if(largeMinimum != 0) {
+		void* const p = VirtualAlloc(NULL, round_up(bytes, largeMinimum), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if(p) { return p; }
+	}
+	return VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	void* const raw = mmap(NULL, bytes + huge, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(raw == MAP_FAILED) { return NULL; }
+
+	// Trim the unaligned head and the leftover tail
+	char* const rawBegin = static_cast<char*>(raw);
+	char* const rawEnd = rawBegin + bytes + huge;
+	char* const begin = reinterpret_cast<char*>(round_up(reinterpret_cast<std::uintptr_t>(rawBegin), huge));
+	char* const end = begin + bytes;
+	if(begin != rawBegin) { munmap(rawBegin, begin - rawBegin); }
+	if(end != rawEnd) { munmap(end, rawEnd - end); }
+
+#ifdef MADV_HUGEPAGE
+	madvise(begin, bytes, MADV_HUGEPAGE);
+#endif
+	return begin;
+#endif
+}
+
+///////////////////////////////////////
+// File mappings
+///////////////////////////////////////
+// Map a whole file read-only and shared, so the pages come straight from (and stay in) the OS's
+// file cache.  Returns NULL, with bytes set to 0, on failure or if the file is empty (which can't
+// be mapped).  Release with unmap_file(p, bytes).  The file itself is closed again straight away;
+// the mapping keeps it alive.
+inline const void* map_file(const char* const path, std::size_t& bytes) noexcept {
+	bytes = 0;
+#ifdef _WIN32
+	const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE) { return NULL; }
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size) || size.QuadPart <= 0 || std::uint64_t(size.QuadPart) > SIZE_MAX) {
+		CloseHandle(file);
+		return NULL;
+	}
+	const HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if(!mapping) { return NULL; }
+	const void* const p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(p) { bytes = std::size_t(size.QuadPart); }
+	return p;
+#else
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if(fd < 0) { return NULL; }
+	struct stat info;
+	if(fstat(fd, &info) != 0 || info.st_size <= 0 || std::uint64_t(info.st_size) > SIZE_MAX) {
+		close(fd);
+		return NULL;
+	}
+	void* const p = mmap(NULL, std::size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(p == MAP_FAILED) { return NULL; }
+	bytes = std::size_t(info.st_size);
+	return p;
+#endif
+}
+
+inline void unmap_file(const void* const p, const std::size_t bytes) noexcept {
+	if(!p) { return; }
+#ifdef _WIN32
+	(void)bytes;
+	UnmapViewOfFile(p);
+#else
+	munmap(const_cast<void*>(p), bytes);
+#endif
+}
+
+// How a mapping is going to be read, for the OS's read-ahead
+enum class advice { normal, sequential, random, will_need };
+
+// Pass advice about [p, p + bytes) on to the OS.  p needn't be page-aligned; the range is widened
+// to whole pages.  Only a hint, so failures are ignored.  Windows has no equivalent of the access
+// pattern hints, but does have PrefetchVirtualMemory() (on Windows 8 and later) for will_need.
+inline void advise(const void* const p, const std::size_t bytes, const advice a) noexcept {
+	if(bytes == 0) { return; }
+	const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(page_size() - 1);
+	const std::size_t length = reinterpret_cast<std::uintptr_t>(p) + bytes - begin;
+#ifdef _WIN32
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+	if(a == advice::will_need) {
+		WIN32_MEMORY_RANGE_ENTRY range = { reinterpret_cast<void*>(begin), length };
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+#else
+	(void)a;
+	(void)length;
+#endif
+#else
+	static const int flags[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED };
+	madvise(reinterpret_cast<void*>(begin), length, flags[int(a)]);
+#endif
+}
+
+} } }
@@ -0,0 +1,360 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                       //////// kane::task_scheduler ////////                       ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A work-stealing scheduler for loops over index ranges, behind kane::parallel_for() and
+// kane::parallel_reduce() (see Algorithms/Parallel.h).
+//
+// Each thread (the workers, plus the thread that calls run(), which takes slot 0) owns a Chase-Lev
+// deque of index ranges.  A thread works through its range a grain at a time, and whenever its
+// own deque is empty, it splits off the second half of what's left and pushes it there for anyone
+// idle to steal.  This is lazy binary splitting: ranges only get split when there's evidence that
+// someone could use the work (the last piece pushed was stolen), so with uniform work and busy
+// threads the loop runs in a few big pieces, while with irregular work, the expensive parts get
+// split finer and finer as threads run out.  Idle threads pop from their own deque (newest first,
+// for locality) and then steal from the others (oldest, and so biggest, first).
+//
+// The deques are fixed-size (see detail::range_deque); a thread whose deque is full just doesn't
+// split.  With lazy splitting, a deque rarely holds more than one or two ranges anyway.
+//
+// run() runs one loop at a time; concurrent callers take turns.  Calling run() from inside a loop
+// body running on the same scheduler runs the inner loop serially on the current thread, rather
+// than deadlocking.  If a body throws, the rest of the loop is skipped and the first exception is
+// rethrown from run().
+//
+// Between loops, the workers sleep on a condition variable; during a loop, idle workers spin
+// (yielding) looking for work to steal.
+#pragma once
+
+#include <KaneLib/Config.h>
+#include <KaneLib/Threading/ThreadPool.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace kane {
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// range_deque
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A fixed-capacity Chase-Lev work-stealing deque of [begin, end) index ranges.  The owning thread
+// pushes and takes at the bottom; any other thread steals from the top.  Memory orderings follow
+// Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models"
+// (PPoPP 2013).
+//
+// Since the array never grows, a slot is only rewritten once the top has moved a whole capacity
+// past it, so a thief that reads a range and then loses the race for it has just read a stale
+// range it's going to throw away.  The range's halves are separate atomics so even that is
+// well-defined.
+class range_deque {
+public:
+	static constexpr std::int64_t capacity = 64;
+
+	range_deque() noexcept : m_top(0), m_bottom(0) { }
+	range_deque(const range_deque&) = delete;
+	range_deque& operator=(const range_deque&) = delete;
+
+	// Owner only.  Returns false if the deque is full.
+	bool push(const std::size_t begin, const std::size_t end) noexcept {
+		const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+		const std::int64_t t = m_top.load(std::memory_order_acquire);
+		if(b - t >= capacity) { return false; }
+		m_begins[b & (capacity - 1)].store(begin, std::memory_order_relaxed);
+		m_ends[b & (capacity - 1)].store(end, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Owner only.  Takes the most recently pushed range; returns false if there wasn't one.
+	bool take(std::size_t& begin, std::size_t& end) noexcept {
+		const std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t t = m_top.load(std::memory_order_relaxed);
+
+		if(t > b) {
+			// Empty
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		begin = m_begins[b & (capacity - 1)].load(std::memory_order_relaxed);
+		end = m_ends[b & (capacity - 1)].load(std::memory_order_relaxed);
+		if(t == b) {
+			// Last one, so race any thieves for it
+			const bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	// Any thread.  Takes the oldest range; returns false if there wasn't one, or another thread
+	// got it first.
+	bool steal(std::size_t& begin, std::size_t& end) noexcept {
+		std::int64_t t = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const std::int64_t b = m_bottom.load(std::memory_order_acquire);
+		if(t >= b) { return false; }
+
+		begin = m_begins[t & (capacity - 1)].load(std::memory_order_relaxed);
+		end = m_ends[t & (capacity - 1)].load(std::memory_order_relaxed);
+		return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	// Owner only, and only a hint
+	bool empty() const noexcept { return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed); }
+
+private:
+	// Thieves hammer the top, the owner the bottom
+	alignas(KANELIB_CACHE_LINE_SIZE) std::atomic<std::int64_t> m_top;
+	alignas(KANELIB_CACHE_LINE_SIZE) std::atomic<std::int64_t> m_bottom;
+	std::atomic<std::size_t> m_begins[capacity];
+	std::atomic<std::size_t> m_ends[capacity];
+};
+
+}
+
+class task_scheduler {
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Start threadCount worker threads.  The thread calling run() works too, so loops run
+	// threadCount + 1 wide.
+	explicit task_scheduler(unsigned threadCount = thread_pool::default_thread_count());
+	task_scheduler(const task_scheduler&) = delete;
+	task_scheduler& operator=(const task_scheduler&) = delete;
+	// Stops and joins the workers.  No loop may be running.
+	~task_scheduler();
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Loops
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Call body(slot, begin, end) for disjoint ranges covering [0, count), each at most grain
+	// long (grain must be at least 1), in parallel, and wait for them all.  slot identifies the
+	// calling thread, from 0 to concurrency() - 1, and no two bodies run on the same slot at
+	// once, so per-slot state needs no locking.
+	template<typename Body>
+	void run(std::size_t count, std::size_t grain, Body&& body);
+
+	// Number of threads loops run on, including the caller
+	unsigned concurrency() const noexcept { return m_threadCount + 1; }
+
+private:
+	// Slot of the current thread, and the scheduler it belongs to, while it's running a loop
+	static task_scheduler*& current_scheduler() noexcept { static thread_local task_scheduler* scheduler = NULL; return scheduler; }
+	static unsigned& current_slot() noexcept { static thread_local unsigned slot = 0; return slot; }
+	// Makes the current thread a slot of a scheduler until it goes out of scope, then restores
+	// whatever it was before: a worker of one scheduler running a loop on another goes back to
+	// being that worker afterwards
+	class slot_scope {
+	public:
+		slot_scope(task_scheduler* const scheduler, const unsigned slot) noexcept : m_scheduler(current_scheduler()), m_slot(current_slot()) {
+			current_scheduler() = scheduler;
+			current_slot() = slot;
+		}
+		~slot_scope() {
+			current_scheduler() = m_scheduler;
+			current_slot() = m_slot;
+		}
+		slot_scope(const slot_scope&) = delete;
+		slot_scope& operator=(const slot_scope&) = delete;
+
+	private:
+		task_scheduler* m_scheduler;
+		unsigned m_slot;
+	};
+
+	void worker(unsigned slot);
+	void stop() noexcept;
+	// Take and steal ranges of the current loop until it's finished
+	void work(unsigned slot);
+	// Work through a range, splitting off halves when our deque runs dry
+	void process(unsigned slot, std::size_t begin, std::size_t end);
+	void run_leaf(unsigned slot, std::size_t begin, std::size_t end);
+	bool steal(unsigned slot, std::size_t& begin, std::size_t& end);
+
+	std::unique_ptr<std::thread[]> m_threads;
+	unsigned m_threadCount;
+	// One per slot, the caller's first
+	std::unique_ptr<detail::range_deque[]> m_deques;
+
+	// Serialises callers of run()
+	std::mutex m_runMutex;
+
+	// Loop state, written under m_mutex before the workers are woken
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_finished;
+	void (*m_call)(void*, unsigned, std::size_t, std::size_t);
+	void* m_context;
+	std::size_t m_grain;
+	std::atomic<std::size_t> m_remaining;	// elements not yet processed (or skipped)
+	std::atomic<bool> m_cancelled;			// a body threw, so skip the rest
+	std::exception_ptr m_exception;
+	unsigned m_busy;						// workers yet to leave the current loop
+	std::uint64_t m_generation;				// bumped for every loop
+	bool m_stop;
+};
+
+// The scheduler used by kane::parallel_for() and friends, started on first use
+inline task_scheduler& default_task_scheduler() {
+	static task_scheduler scheduler;
+	return scheduler;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline task_scheduler::task_scheduler(const unsigned threadCount)
+	: m_threads(new std::thread[threadCount]), m_threadCount(0), m_deques(new detail::range_deque[threadCount + 1]),
+	  m_call(NULL), m_context(NULL), m_grain(1), m_remaining(0), m_cancelled(false), m_busy(0), m_generation(0), m_stop(false) {
+	// Count the threads as they start, so stop() only joins real ones if one fails to start
+	try {
+		for(; m_threadCount != threadCount; ++m_threadCount) {
+			m_threads[m_threadCount] = std::thread(&task_scheduler::worker, this, m_threadCount + 1);
+		}
+	} catch(...) {
+		stop();
+		throw;
+	}
+}
+
+inline task_scheduler::~task_scheduler() { stop(); }
+
+inline void task_scheduler::stop() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	for(unsigned i = 0; i != m_threadCount; ++i) { m_threads[i].join(); }
+	m_threadCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Loops
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename Body>
+inline void task_scheduler::run(const std::size_t count, const std::size_t grain, Body&& body) {
+	typedef std::remove_reference_t<Body> body_type;
+	if(count == 0) { return; }
+
+	// Nested in one of our own loops, or not worth splitting
+	// (The current slot is only ours if the thread is one of our own; otherwise, it's slot 0, like
+	// any other caller)
+	if(current_scheduler() == this || m_threadCount == 0 || count <= grain) {
+		body(current_scheduler() == this ? current_slot() : 0u, std::size_t(0), count);
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock(m_runMutex);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_call = [](void* const context, const unsigned slot, const std::size_t begin, const std::size_t end) {
+			(*static_cast<body_type*>(context))(slot, begin, end);
+		};
+		m_context = const_cast<void*>(static_cast<const void*>(std::addressof(body)));
+		m_grain = grain;
+		m_remaining.store(count, std::memory_order_relaxed);
+		m_cancelled.store(false, std::memory_order_relaxed);
+		m_exception = NULL;
+		m_busy = m_threadCount;
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	// Start on the whole range ourselves; the workers will steal from us
+	{
+		slot_scope scope(this, 0);
+		process(0, 0, count);
+		work(0);
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_finished.wait(lock, [this] { return m_busy == 0; });
+	if(m_exception) { std::rethrow_exception(m_exception); }
+}
+
+inline void task_scheduler::worker(const unsigned slot) {
+	const slot_scope scope(this, slot);
+
+	std::uint64_t seen = 0;
+	for(;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+			if(m_stop) { return; }
+			seen = m_generation;
+		}
+
+		work(slot);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if(--m_busy == 0) { m_finished.notify_one(); }
+	}
+}
+
+inline void task_scheduler::work(const unsigned slot) {
+	std::size_t begin, end;
+	while(m_remaining.load(std::memory_order_acquire) != 0) {
+		if(m_deques[slot].take(begin, end) || steal(slot, begin, end)) {
+			process(slot, begin, end);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+inline void task_scheduler::process(const unsigned slot, std::size_t begin, std::size_t end) {
+	const std::size_t grain = m_grain;
+	while(end - begin > grain) {
+		// Nobody's taken the last half we offered (or we never offered one), so offer another
+		if(m_deques[slot].empty()) {
+			const std::size_t middle = begin + (end - begin) / 2;
+			if(m_deques[slot].push(middle, end)) {
+				end = middle;
+				continue;
+			}
+		}
+		run_leaf(slot, begin, begin + grain);
+		begin += grain;
+	}
+	run_leaf(slot, begin, end);
+}
+
+inline void task_scheduler::run_leaf(const unsigned slot, const std::size_t begin, const std::size_t end) {
+	if(!m_cancelled.load(std::memory_order_relaxed)) {
+		try {
+			m_call(m_context, slot, begin, end);
+		} catch(...) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(!m_exception) { m_exception = std::current_exception(); }
+			m_cancelled.store(true, std::memory_order_relaxed);
+		}
+	}
+	m_remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
+}
+
+inline bool task_scheduler::steal(const unsigned slot, std::size_t& begin, std::size_t& end) {
+	// Round-robin from our neighbour, so thieves spread out
+	const unsigned slots = concurrency();
+	for(unsigned i = 1; i != slots; ++i) {
+		if(m_deques[(slot + i) % slots].steal(begin, end)) { return true; }
+	}
+	return false;
+}
+
+}
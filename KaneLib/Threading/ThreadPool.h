@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////                         //////// kane::thread_pool ////////                        ////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A small, fixed set of worker threads for splitting one big job into independent pieces.
+// run(count, fn) calls fn(i) for every i in [0, count), spread across the workers and the calling
+// thread, and returns once they've all finished.  Pieces are handed out from a shared counter, so
+// a slow piece doesn't hold up the rest.
+//
+// This is deliberately not a general-purpose task system: it runs one job at a time (concurrent
+// callers of run() take turns), and fn mustn't throw or call run() on the same pool.  It exists
+// for the library's own bulk operations, like parallel_copy() in Algorithms/Parallel.h.
+//
+// The workers sleep on a condition variable between jobs, so an idle pool costs nothing but its
+// threads' stacks.
+#pragma once
+
+#include <KaneLib/Config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace kane {
+
+class thread_pool {
+public:
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructors
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Start threadCount worker threads.  (The thread calling run() works too, so a pool of N
+	// workers runs jobs N+1 wide.)
+	explicit thread_pool(unsigned threadCount = default_thread_count());
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+	// Stops and joins the workers.  No job may be running.
+	~thread_pool();
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Jobs
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Call fn(i) for each i in [0, count), in parallel, and wait for them all
+	template<typename Function>
+	void run(std::size_t count, Function&& fn);
+
+	// Number of worker threads, not counting the caller
+	unsigned size() const noexcept { return m_threadCount; }
+
+	// One fewer than the number of hardware threads (the caller is the last one), but no more than
+	// 7.  Bulk memory operations stop scaling long before the core count runs out.
+	static unsigned default_thread_count() noexcept {
+		const unsigned hardware = std::thread::hardware_concurrency();
+		return (hardware > 1) ? std::min(hardware - 1, 7u) : 0u;
+	}
+
+private:
+	void worker();
+	// Stop and join the workers
+	void stop() noexcept;
+	// Take pieces of the current job until there are none left
+	void run_pieces();
+
+	std::unique_ptr<std::thread[]> m_threads;
+	unsigned m_threadCount;
+
+	// Serialises callers of run()
+	std::mutex m_runMutex;
+
+	// Job state, written under m_mutex before the workers are woken
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_finished;
+	void (*m_call)(void*, std::size_t);
+	void* m_context;
+	std::size_t m_count;
+	std::atomic<std::size_t> m_next;
+	unsigned m_busy;				// workers yet to finish the current job
+	std::uint64_t m_generation;		// bumped for every job, so workers can tell a new one apart
+	bool m_stop;
+};
+
+// The pool used by the library's own parallel operations, started on first use
+inline thread_pool& default_thread_pool() {
+	static thread_pool pool;
+	return pool;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline thread_pool::thread_pool(const unsigned threadCount)
+	: m_threads(new std::thread[threadCount]), m_threadCount(0), m_call(NULL), m_context(NULL), m_count(0),
+	  m_next(0), m_busy(0), m_generation(0), m_stop(false) {
+	// Count the threads as they start, so stop() only joins real ones if one fails to start
+	try {
+		for(; m_threadCount != threadCount; ++m_threadCount) {
+			m_threads[m_threadCount] = std::thread(&thread_pool::worker, this);
+		}
+	} catch(...) {
+		stop();
+		throw;
+	}
+}
+
+inline thread_pool::~thread_pool() { stop(); }
+
+inline void thread_pool::stop() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	for(unsigned i = 0; i != m_threadCount; ++i) { m_threads[i].join(); }
+	m_threadCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Jobs
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename Function>
+inline void thread_pool::run(const std::size_t count, Function&& fn) {
+	typedef std::remove_reference_t<Function> function_type;
+
+	// Not worth waking anybody for
+	if(count <= 1 || m_threadCount == 0) {
+		for(std::size_t i = 0; i != count; ++i) { fn(i); }
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock(m_runMutex);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_call = [](void* const context, const std::size_t i) { (*static_cast<function_type*>(context))(i); };
+		m_context = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+		m_count = count;
+		m_next.store(0, std::memory_order_relaxed);
+		m_busy = m_threadCount;
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	// Pitch in, then wait for the stragglers
+	run_pieces();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_finished.wait(lock, [this] { return m_busy == 0; });
+}
+
+inline void thread_pool::worker() {
+	std::uint64_t seen = 0;
+	for(;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+			if(m_stop) { return; }
+			seen = m_generation;
+		}
+
+		run_pieces();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if(--m_busy == 0) { m_finished.notify_one(); }
+	}
+}
+
+inline void thread_pool::run_pieces() {
+	for(std::size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count; i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+		m_call(m_context, i);
+	}
+}
+
+}
@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Bit-twiddling utilities
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <KaneLib/Config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace kane {
+
+///////////////////////////////////////////////////////////////////////////////
+// Powers of two
+///////////////////////////////////////////////////////////////////////////////
+// True if n is a power of two.  (Zero isn't.)
+template<typename T>
+constexpr bool is_power_of_two(const T n) {
+	static_assert(std::is_unsigned<T>::value, "is_power_of_two requires an unsigned type");
+	return n != 0 && (n & (n - 1)) == 0;
+}
+
+// Smallest power of two no less than n, or 1 if n is 0.  Wraps to 0 if the result doesn't fit in T.
+template<typename T>
+constexpr T next_power_of_two(T n) {
+	static_assert(std::is_unsigned<T>::value, "next_power_of_two requires an unsigned type");
+	if(n <= 1) { return 1; }
+	// Smear the highest set bit of n-1 into every bit below it, then add one
+	--n;
+	for(std::size_t shift = 1; shift < sizeof(T) * 8; shift <<= 1) { n |= n >> shift; }
+	return n + 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Bit scans
+///////////////////////////////////////////////////////////////////////////////
+// Index of the lowest set bit of n, which mustn't be zero.  A single instruction (BSF/TZCNT) on 
+// x86.
+template<typename T>
+KFINLINE unsigned bit_scan_forward(const T n) {
+	static_assert(std::is_unsigned<T>::value && sizeof(T) <= 8, "bit_scan_forward requires an unsigned type of at most 64 bits");
+#ifdef _MSC_VER
+	unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+	_BitScanForward64(&index, std::uint64_t(n));
+#else
+	if(std::uint32_t(n) != 0) { _BitScanForward(&index, std::uint32_t(n)); }
+	else { _BitScanForward(&index, std::uint32_t(std::uint64_t(n) >> 32)); index += 32; }
+#endif
+	return unsigned(index);
+#else
+	return unsigned(__builtin_ctzll(std::uint64_t(n)));
+#endif
+}
+
+// Index of the highest set bit of n, which mustn't be zero.  That's floor(log2(n)).  A single 
+// instruction (BSR/LZCNT) on x86.
+template<typename T>
+KFINLINE unsigned bit_scan_reverse(const T n) {
+	static_assert(std::is_unsigned<T>::value && sizeof(T) <= 8, "bit_scan_reverse requires an unsigned type of at most 64 bits");
+#ifdef _MSC_VER
+	unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+	_BitScanReverse64(&index, std::uint64_t(n));
+#else
+	if(std::uint64_t(n) >> 32) { _BitScanReverse(&index, std::uint32_t(std::uint64_t(n) >> 32)); index += 32; }
+	else { _BitScanReverse(&index, std::uint32_t(n)); }
+#endif
+	return unsigned(index);
+#else
+	return 63u - unsigned(__builtin_clzll(std::uint64_t(n)));
+#endif
+}
+
+}
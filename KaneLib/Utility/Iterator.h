@@ -98,6 +98,12 @@ using is_forward_iterator = std::is_base_of<std::forward_iterator_tag, iterator_
 template<typename Itr>
 constexpr bool is_forward_iterator_v = is_forward_iterator<Itr>::value;
 
+// Determine if random access iterator
+template<typename Itr>
+using is_random_access_iterator = std::is_base_of<std::random_access_iterator_tag, iterator_category_or_void_t<Itr>>;
+template<typename Itr>
+constexpr bool is_random_access_iterator_v = is_random_access_iterator<Itr>::value;
+
 // enable_if is iterator shortcut
 template<typename Itr, typename V = void>
 using enable_if_iterator = std::enable_if<is_iterator<Itr>::value, V>;
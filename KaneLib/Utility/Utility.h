@@ -4,6 +4,7 @@
 #pragma once
 
 #include <KaneLib/Config.h>
+#include <cstddef>
 #include <string>
 #include <iostream>
 //#include <boost/iostreams/concepts.hpp>
@@ -22,6 +23,23 @@ namespace kane {
 struct no_default_construct_t { };
 static const no_default_construct_t no_default_construct = no_default_construct_t();
 
+///////////////////////////////////////////////////////////////////////////////
+// kane::zeroed
+///////////////////////////////////////////////////////////////////////////////
+// Tag for constructors and resize() overloads which fill new elements with zero bytes instead of
+// constructing them, so containers can get their memory pre-zeroed from the allocator (calloc(),
+// or fresh pages from the OS) rather than touching every byte themselves.
+struct zeroed_t { };
+static const zeroed_t zeroed = zeroed_t();
+
+///////////////////////////////////////////////////////////////////////////////
+// kane::par
+///////////////////////////////////////////////////////////////////////////////
+// Execution policy tag for container operations which split their work across threads (see 
+// Algorithms/Parallel.h), like std::execution::par, but without dragging in <execution>.
+struct parallel_t { };
+static const parallel_t par = parallel_t();
+
 ///////////////////////////////////////////////////////////////////////////////
 // Initial capacity initialiser
 ///////////////////////////////////////////////////////////////////////////////
@@ -51,6 +69,18 @@ template<typename T> KFINLINE capacity_tag_t<T> capacity(const T value) {
 	return result; 
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// kane::allocation_result
+///////////////////////////////////////////////////////////////////////////////
+// Result of an allocator's allocate_at_least(): the array, and how many elements it can actually 
+// hold, which may be more than were asked for.  Same layout as C++23's std::allocation_result, so
+// allocators written for that will work unchanged once we're on C++23.
+template<typename Pointer, typename SizeType = std::size_t>
+struct allocation_result {
+	Pointer ptr;
+	SizeType count;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
                                       // String Utilities //                                       
 ///////////////////////////////////////////////////////////////////////////////////////////////////
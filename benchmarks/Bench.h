@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmark helpers
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Shared bits for the standalone benchmarks in this directory.  Each .cpp is a complete program
+// with its own main(), built straight from the command line with the repository root on the
+// include path, and with optimisations and the instruction set you're going to ship with:
+//
+//   cl /std:c++17 /O2 /EHsc /arch:AVX2 /I.. RadixSort.cpp
+//   g++ -std=c++17 -O2 -mavx2 -pthread -I.. RadixSort.cpp -o RadixSort
+//
+// They print plain tables to stdout.  Timings are the best of several runs, which is the number
+// least disturbed by whatever else the machine is doing; run them on an otherwise idle machine
+// anyway.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace bench {
+
+typedef std::chrono::steady_clock::time_point time_point;
+
+inline time_point now() { return std::chrono::steady_clock::now(); }
+
+// Seconds elapsed since start
+inline double seconds_since(const time_point start) {
+	return std::chrono::duration<double>(now() - start).count();
+}
+
+// Time fn(), returning its duration in seconds
+template<typename Function>
+inline double time_once(Function&& fn) {
+	const time_point start = now();
+	fn();
+	return seconds_since(start);
+}
+
+// Best time of reps calls to fn()
+template<typename Function>
+inline double best_of(const int reps, Function&& fn) {
+	double best = time_once(fn);
+	for(int i = 1; i < reps; ++i) { best = std::min(best, time_once(fn)); }
+	return best;
+}
+
+// Keep the compiler from throwing away a result nobody looks at
+template<typename T>
+inline void do_not_optimise(const T& value) {
+	static volatile T sink;
+	sink = value;
+}
+
+// Small, fast and deterministic, so every run (and every contender) sees the same data
+class random {
+public:
+	explicit random(const std::uint64_t seed = 0x9E3779B97F4A7C15ull) noexcept : m_state(seed) { }
+
+	// splitmix64
+	std::uint64_t next() noexcept {
+		std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+	// Uniform in [0, n)
+	std::uint64_t below(const std::uint64_t n) noexcept { return next() % n; }
+	// Uniform in [0, 1)
+	double unit() noexcept { return double(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+	std::uint64_t m_state;
+};
+
+// The first command-line argument as a number, or fallback if there isn't one.  The benchmarks
+// use it to scale their biggest sizes down for small machines.
+inline std::size_t size_argument(const int argc, char** const argv, const std::size_t fallback) {
+	return (argc > 1) ? std::size_t(std::strtoull(argv[1], NULL, 10)) : fallback;
+}
+
+}
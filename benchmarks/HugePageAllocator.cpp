@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// kane::huge_page_allocator random gather
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Sums a table of uint64s at precomputed random indices, which on a table far bigger than the TLB
+// reach of 4KB pages misses the TLB on nearly every load.  The table comes from std::allocator and
+// from huge_page_allocator, each with transparent huge pages available and again with them
+// switched off for the process (prctl(PR_SET_THP_DISABLE)).  The last row is huge_page_allocator
+// falling back to ordinary pages, which should cost no more than std::allocator does.
+//
+// With THP set to "always" std::allocator's block may get huge pages too, so the AnonHugePages
+// column (Linux only) shows how much of each table actually ended up on them.  On Windows there's
+// no switch; huge_page_allocator only gets large pages with the "Lock pages in memory" privilege,
+// and without it the second row is the fallback.
+//
+//   HugePageAllocator [table MB]		(default 1024)
+#include "Bench.h"
+
+#include <KaneLib/Memory/HugePageAllocator.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+namespace {
+
+constexpr int reps = 5;
+constexpr std::size_t gathers = std::size_t(1) << 24;
+
+// Anonymous memory on huge pages, in KB, or -1 if we can't tell
+long huge_page_kb() {
+#ifdef __linux__
+	std::FILE* const file = std::fopen("/proc/self/smaps_rollup", "r");
+	if(!file) { return -1; }
+	long kb = -1;
+	char line[256];
+	while(std::fgets(line, sizeof(line), file)) {
+		if(std::strncmp(line, "AnonHugePages:", 14) == 0) { kb = std::strtol(line + 14, NULL, 10); break; }
+	}
+	std::fclose(file);
+	return kb;
+#else
+	return -1;
+#endif
+}
+
+bool set_thp(const bool enabled) {
+#ifdef __linux__
+	return prctl(PR_SET_THP_DISABLE, enabled ? 0 : 1, 0, 0, 0) == 0;
+#else
+	return enabled;
+#endif
+}
+
+template<typename Alloc>
+void run(const char* const name, const std::size_t count, const std::vector<std::uint32_t>& indices) {
+	Alloc alloc;
+	const long hugeBefore = huge_page_kb();
+	std::uint64_t* const table = alloc.allocate(count);
+	for(std::size_t i = 0; i != count; ++i) { table[i] = i; }
+	const long hugeAfter = huge_page_kb();
+
+	const double seconds = bench::best_of(reps, [&] {
+		std::uint64_t total = 0;
+		for(const std::uint32_t i : indices) { total += table[i]; }
+		bench::do_not_optimise(total);
+	});
+	alloc.deallocate(table, count);
+
+	std::printf("%-34s %10.1f %10.2f", name, double(gathers) / seconds * 1e-6, seconds * 1e9 / double(gathers));
+	if(hugeBefore >= 0 && hugeAfter >= 0) {
+		std::printf(" %12ld\n", (hugeAfter - hugeBefore) / 1024);
+	} else {
+		std::printf(" %12s\n", "?");
+	}
+}
+
+}
+
+int main(int argc, char** argv) {
+	const std::size_t megabytes = bench::size_argument(argc, argv, 1024);
+	const std::size_t count = megabytes * 1024 * 1024 / sizeof(std::uint64_t);
+
+	// Same indices for every allocator
+	std::vector<std::uint32_t> indices(gathers);
+	bench::random rng;
+	for(std::uint32_t& i : indices) { i = std::uint32_t(rng.below(count)); }
+
+	std::printf("%zu MB table, %zu random gathers\n\n", megabytes, gathers);
+	std::printf("%-34s %10s %10s %12s\n", "", "Mgather/s", "ns/gather", "huge MB");
+	run<std::allocator<std::uint64_t>>("std::allocator", count, indices);
+	run<kane::huge_page_allocator<std::uint64_t>>("huge_page_allocator", count, indices);
+
+	if(set_thp(false)) {
+		run<std::allocator<std::uint64_t>>("std::allocator, THP off", count, indices);
+		run<kane::huge_page_allocator<std::uint64_t>>("huge_page_allocator, THP off", count, indices);
+		set_thp(true);
+	}
+	return 0;
+}
@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// kane::radix_sort vs std::sort
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// radix_sort() and radix_sort(kane::par, ...) against std::sort() on random uint32s, uint64s,
+// floats and 16-byte records keyed by a float, at a thousand, a million and a hundred million
+// elements (the last needs a few GB; pass a smaller maximum on the command line).  Then the sweeps
+// behind the constants in RadixSort.h:
+//
+//  - cutoff: insertion sort against counting and std::sort() on arrays of 16 to 512 uint32s.
+//    radix_insertion_threshold (64) should be about where counting starts winning.
+//  - digits: the library's 8-bit digits against a reference LSD sort here with 11- and 16-bit
+//    digits.  Fewer passes, but bigger histograms that fall out of L1, and more scattered write
+//    streams than the store buffers and TLB can keep up with.
+//  - parallel: detail::parallel_radix_sort() against the serial sort from 2^14 to 2^22 uint32s.
+//    KANELIB_PARALLEL_SORT_THRESHOLD (2^18) should be about where it starts paying for itself;
+//    rebuild with -DKANELIB_PARALLEL_SORT_THRESHOLD=... to move it.
+//
+//   RadixSort [largest size]		(default 100000000)
+#include "Bench.h"
+
+#include <KaneLib/Collections/Vector.h>
+#include <KaneLib/Algorithms/RadixSort.h>
+#include <KaneLib/Utility/Bits.h>
+
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+struct record {
+	std::uint64_t id;
+	float score;
+	std::uint32_t flags;
+};
+
+// Best time to sort a fresh copy of source with sort, checking the result is in order by key
+template<typename T, typename Sort, typename Key>
+double time_sort(const kane::vector<T>& source, Sort&& sort, Key&& key) {
+	const int reps = (source.size() >= 10000000) ? 1 : (source.size() >= 100000) ? 5 : 50;
+	kane::vector<T> work;
+	double best = 0;
+	for(int r = 0; r != reps; ++r) {
+		work = source;
+		const double seconds = bench::time_once([&] { sort(work); });
+		if(r == 0 || seconds < best) { best = seconds; }
+	}
+	for(std::size_t i = 1; i < work.size(); ++i) {
+		if(key(work[i]) < key(work[i - 1])) { std::fprintf(stderr, "Not sorted\n"); std::exit(1); }
+	}
+	return best;
+}
+
+///////////////////////////////////////
+// Against std::sort()
+///////////////////////////////////////
+template<typename T, typename Generate, typename Key>
+void compare(const char* const name, const std::size_t count, Generate&& generate, Key&& key) {
+	kane::vector<T> source(count);
+	bench::random rng;
+	for(T& x : source) { x = generate(rng); }
+
+	const auto less = [&](const T& a, const T& b) { return key(a) < key(b); };
+	const double stdSort = time_sort(source, [&](kane::vector<T>& v) { std::sort(v.begin(), v.end(), less); }, key);
+	double radix, parallel;
+	if constexpr(std::is_arithmetic<T>::value) {
+		radix = time_sort(source, [](kane::vector<T>& v) { kane::radix_sort(v); }, key);
+		parallel = time_sort(source, [](kane::vector<T>& v) { kane::radix_sort(kane::par, v); }, key);
+	} else {
+		radix = time_sort(source, [&](kane::vector<T>& v) { kane::radix_sort(v, key); }, key);
+		parallel = time_sort(source, [&](kane::vector<T>& v) { kane::radix_sort(kane::par, v, key); }, key);
+	}
+
+	const double perElement = 1e9 / double(count);
+	std::printf("%-8s %10zu %11.2f %11.2f (%5.2fx) %11.2f (%5.2fx)\n", name, count, stdSort * perElement,
+		radix * perElement, stdSort / radix, parallel * perElement, stdSort / parallel);
+}
+
+void compare_table(const std::size_t largest) {
+	std::printf("ns/element          count    std::sort      radix_sort    radix_sort(par)\n");
+	const std::size_t sizes[] = { 1000, 1000000, 100000000 };
+	std::size_t previous = 0;
+	for(const std::size_t size : sizes) {
+		// Sizes above the largest all come out the same, so only run that once
+		const std::size_t count = std::min(size, largest);
+		if(count == previous) { break; }
+		previous = count;
+		compare<std::uint32_t>("uint32", count, [](bench::random& rng) { return std::uint32_t(rng.next()); }, [](const std::uint32_t x) { return x; });
+		compare<std::uint64_t>("uint64", count, [](bench::random& rng) { return rng.next(); }, [](const std::uint64_t x) { return x; });
+		compare<float>("float", count, [](bench::random& rng) { return float((rng.unit() - 0.5) * 2e6); }, [](const float x) { return x; });
+		compare<record>("record", count, [](bench::random& rng) { return record{ rng.next(), float(rng.unit() * 1e6), 0 }; },
+			[](const record& r) { return r.score; });
+	}
+	std::printf("\n");
+}
+
+///////////////////////////////////////
+// Insertion sort cutoff
+///////////////////////////////////////
+void cutoff_table() {
+	// Lots of small arrays, about a million elements in all
+	std::printf("cutoff   ns/element: insertion    counting   std::sort\n");
+	const std::size_t sizes[] = { 16, 32, 48, 64, 96, 128, 256, 512 };
+	kane::detail::radix_identity_key key;
+	for(const std::size_t n : sizes) {
+		const std::size_t arrays = (std::size_t(1) << 20) / n;
+		kane::vector<std::uint32_t> source(arrays * n), work(arrays * n), scratch(n);
+		bench::random rng;
+		for(std::uint32_t& x : source) { x = std::uint32_t(rng.next()); }
+
+		const auto each = [&](auto&& sort) {
+			return bench::best_of(5, [&] {
+				std::memcpy(work.data(), source.data(), source.size() * sizeof(std::uint32_t));
+				for(std::size_t a = 0; a != arrays; ++a) { sort(work.data() + a * n); }
+			});
+		};
+		// The copy is in all three, so take it out
+		const double copy = each([](std::uint32_t*) { });
+		const double insertion = each([&](std::uint32_t* const p) { kane::detail::radix_insertion_sort(p, p + n, key); });
+		const double counting = each([&](std::uint32_t* const p) { kane::detail::radix_sort(p, scratch.data(), n, key); });
+		const double stdSort = each([&](std::uint32_t* const p) { std::sort(p, p + n); });
+
+		const double perElement = 1e9 / double(source.size());
+		std::printf("%6zu%s %22.2f %11.2f %11.2f\n", n, (n == kane::detail::radix_insertion_threshold) ? " *" : "  ",
+			(insertion - copy) * perElement, (counting - copy) * perElement, (stdSort - copy) * perElement);
+	}
+	std::printf("(* radix_insertion_threshold)\n\n");
+}
+
+///////////////////////////////////////
+// Digit size
+///////////////////////////////////////
+// Plain LSD radix sort of unsigned integers with Bits-bit digits, structured like
+// detail::radix_sort(): every histogram in one read, trivial digits skipped
+template<unsigned Bits, typename T>
+void lsd_sort(T* const data, T* const scratch, const std::size_t count) {
+	constexpr unsigned digits = (sizeof(T) * 8 + Bits - 1) / Bits;
+	constexpr std::size_t buckets = std::size_t(1) << Bits;
+	const auto digit = [](const T x, const unsigned d) { return std::size_t(x >> (d * Bits)) & (buckets - 1); };
+
+	kane::vector<std::size_t> histograms(digits * buckets, 0);
+	for(const T* p = data, *end = data + count; p != end; ++p) {
+		for(unsigned d = 0; d != digits; ++d) { ++histograms[d * buckets + digit(*p, d)]; }
+	}
+
+	T* src = data;
+	T* dest = scratch;
+	for(unsigned d = 0; d != digits; ++d) {
+		std::size_t* const histogram = histograms.data() + d * buckets;
+		if(histogram[digit(*data, d)] == count) { continue; }
+		std::size_t offset = 0;
+		for(std::size_t b = 0; b != buckets; ++b) {
+			const std::size_t n = histogram[b];
+			histogram[b] = offset;
+			offset += n;
+		}
+		for(const T* p = src, *end = src + count; p != end; ++p) { dest[histogram[digit(*p, d)]++] = *p; }
+		std::swap(src, dest);
+	}
+	if(src != data) { std::memcpy(data, src, count * sizeof(T)); }
+}
+
+template<typename T>
+void digits_row(const char* const name, const std::size_t count) {
+	kane::vector<T> source(count), scratch(count);
+	bench::random rng;
+	for(T& x : source) { x = T(rng.next()); }
+
+	const auto identity = [](const T x) { return x; };
+	const double library = time_sort(source, [](kane::vector<T>& v) { kane::radix_sort(v); }, identity);
+	const double eleven = time_sort(source, [&](kane::vector<T>& v) { lsd_sort<11>(v.data(), scratch.data(), v.size()); }, identity);
+	const double sixteen = time_sort(source, [&](kane::vector<T>& v) { lsd_sort<16>(v.data(), scratch.data(), v.size()); }, identity);
+
+	const double perElement = 1e9 / double(count);
+	std::printf("%-8s %10zu %11.2f %11.2f %11.2f\n", name, count, library * perElement, eleven * perElement, sixteen * perElement);
+}
+
+void digits_table(const std::size_t largest) {
+	std::printf("digits ns/element   count      8 bits     11 bits     16 bits\n");
+	const std::size_t sizes[] = { 1000000, 16000000, 100000000 };
+	std::size_t previous = 0;
+	for(const std::size_t size : sizes) {
+		const std::size_t count = std::min(size, largest);
+		if(count == previous) { break; }
+		previous = count;
+		digits_row<std::uint32_t>("uint32", count);
+		digits_row<std::uint64_t>("uint64", count);
+	}
+	std::printf("\n");
+}
+
+///////////////////////////////////////
+// Parallel threshold
+///////////////////////////////////////
+void parallel_table() {
+	std::printf("parallel ns/element      serial    parallel\n");
+	kane::detail::radix_identity_key key;
+	for(std::size_t count = std::size_t(1) << 14; count <= (std::size_t(1) << 22); count *= 2) {
+		kane::vector<std::uint32_t> source(count), scratch(count);
+		bench::random rng;
+		for(std::uint32_t& x : source) { x = std::uint32_t(rng.next()); }
+
+		const auto identity = [](const std::uint32_t x) { return x; };
+		const double serial = time_sort(source, [&](kane::vector<std::uint32_t>& v) { kane::detail::radix_sort(v.data(), scratch.data(), count, key); }, identity);
+		const double parallel = time_sort(source, [&](kane::vector<std::uint32_t>& v) { kane::detail::parallel_radix_sort(v.data(), scratch.data(), count, key); }, identity);
+
+		const double perElement = 1e9 / double(count);
+		std::printf("  2^%-2u%s %18.2f %11.2f\n", kane::bit_scan_reverse(count), (count == KANELIB_PARALLEL_SORT_THRESHOLD) ? " *" : "  ",
+			serial * perElement, parallel * perElement);
+	}
+	std::printf("(* KANELIB_PARALLEL_SORT_THRESHOLD)\n");
+}
+
+}
+
+int main(int argc, char** argv) {
+	const std::size_t largest = bench::size_argument(argc, argv, 100000000);
+
+	compare_table(largest);
+	cutoff_table();
+	digits_table(largest);
+	parallel_table();
+	return 0;
+}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// kane::small_vector vs kane::vector
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// small_vector<int, N> against kane::vector<int>, for N = 4, 8 and 16, each filled to half of N,
+// exactly N and twice N elements (so the last one has spilled to the heap):
+//
+//  - churn: a short-lived local vector per "request", filled, summed and destroyed, which is
+//    where the inline buffer saves a heap allocation (or several, as a vector grows) every time.
+//    kane::vector is timed both growing naturally and reserve()d up front.
+//  - nested: a vector of a million small vectors, built and then summed, where the inline
+//    elements sit next to each other instead of behind a pointer each.
+//
+//   SmallVector [requests]		(default 2000000)
+#include "Bench.h"
+
+#include <KaneLib/Collections/Vector.h>
+#include <KaneLib/Collections/SmallVector.h>
+
+namespace {
+
+constexpr int reps = 5;
+
+// Fill a fresh container with count elements and sum them, requests times
+template<typename Container>
+double churn(const std::size_t requests, const std::size_t count, const bool reserve) {
+	return bench::best_of(reps, [&] {
+		long long total = 0;
+		for(std::size_t r = 0; r != requests; ++r) {
+			Container c;
+			if(reserve) { c.reserve(count); }
+			for(std::size_t i = 0; i != count; ++i) { c.push_back(int(r + i)); }
+			for(const int x : c) { total += x; }
+		}
+		bench::do_not_optimise(total);
+	});
+}
+
+// Build a vector of outer containers of count elements each, then sum everything
+template<typename Container>
+void nested(const std::size_t outer, const std::size_t count, double& buildSeconds, double& sumSeconds) {
+	kane::vector<Container> all;
+	buildSeconds = bench::best_of(reps, [&] {
+		all.clear();
+		all.reserve(outer);
+		for(std::size_t o = 0; o != outer; ++o) {
+			all.emplace_back();
+			for(std::size_t i = 0; i != count; ++i) { all.back().push_back(int(o + i)); }
+		}
+	});
+	sumSeconds = bench::best_of(reps, [&] {
+		long long total = 0;
+		for(const Container& c : all) {
+			for(const int x : c) { total += x; }
+		}
+		bench::do_not_optimise(total);
+	});
+}
+
+template<std::size_t N>
+void run(const std::size_t requests) {
+	typedef kane::small_vector<int, N> small;
+	typedef kane::vector<int> plain;
+	const std::size_t outer = 1000000;
+
+	const std::size_t counts[] = { N / 2, N, 2 * N };
+	for(const std::size_t count : counts) {
+		const double smallChurn = churn<small>(requests, count, false);
+		const double plainChurn = churn<plain>(requests, count, false);
+		const double reservedChurn = churn<plain>(requests, count, true);
+
+		double smallBuild, smallSum, plainBuild, plainSum;
+		nested<small>(outer, count, smallBuild, smallSum);
+		nested<plain>(outer, count, plainBuild, plainSum);
+
+		const double perRequest = 1e9 / double(requests);
+		const double perOuter = 1e9 / double(outer);
+		std::printf("%4zu %6zu | %9.1f %9.1f %9.1f | %9.1f %9.1f | %9.2f %9.2f\n", N, count,
+			smallChurn * perRequest, plainChurn * perRequest, reservedChurn * perRequest,
+			smallBuild * perOuter, plainBuild * perOuter, smallSum * perOuter, plainSum * perOuter);
+	}
+}
+
+}
+
+int main(int argc, char** argv) {
+	const std::size_t requests = bench::size_argument(argc, argv, 2000000);
+
+	std::printf("Nanoseconds per container (churn: %zu requests; nested: 1000000 containers)\n\n", requests);
+	std::printf("                     churn                   |   nested build      |   nested sum\n");
+	std::printf("   N   size |     small    vector  reserved |     small    vector |     small    vector\n");
+	run<4>(requests);
+	run<8>(requests);
+	run<16>(requests);
+	return 0;
+}
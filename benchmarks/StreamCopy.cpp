@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// kane::stream_copy
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Evidence for KANELIB_STREAMING_THRESHOLD and KANELIB_PREFETCH_DISTANCE, in two parts:
+//
+//  - copy: stream_copy() against memcpy() on its own, from 256KB to 256MB.  memcpy() wins while
+//    the destination fits in the cache and is about to be read again; the threshold should sit
+//    around the size where the two cross over, which is roughly the size of the last-level cache.
+//  - growth: a buffer doubling from 64KB up to the size on the command line, copying into each
+//    new block the way array_container_base relocates trivially copyable elements, while another
+//    thread keeps summing its own 1MB cache-resident buffer.  Reports the time to grow, and how
+//    many passes a second the other thread managed compared with running on its own.  Copies go
+//    with memcpy() throughout, with stream_copy() from the threshold up (what the library does),
+//    and with stream_copy() throughout.
+//
+// The growth part needs a second core to mean anything.  Both constants can be overridden on the
+// command line, so to try other values rebuild with e.g. -DKANELIB_STREAMING_THRESHOLD=4194304 or
+// -DKANELIB_PREFETCH_DISTANCE=512 (/D with cl) and compare the tables.
+//
+//   StreamCopy [growth limit MB]		(default 1024)
+#include "Bench.h"
+
+#include <KaneLib/Algorithms/MemoryOps.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int reps = 5;
+
+// A buffer that's been written to, so page faults aren't part of the timings
+struct buffer {
+	explicit buffer(const std::size_t bytes) : data(static_cast<unsigned char*>(std::malloc(bytes))), size(bytes) {
+		if(!data) { std::fprintf(stderr, "Out of memory\n"); std::exit(1); }
+		std::memset(data, 1, bytes);
+	}
+	~buffer() { std::free(data); }
+	buffer(const buffer&) = delete;
+	buffer& operator=(const buffer&) = delete;
+
+	unsigned char* data;
+	std::size_t size;
+};
+
+///////////////////////////////////////
+// copy
+///////////////////////////////////////
+void copy_table() {
+	std::printf("copy                memcpy GB/s  stream_copy GB/s\n");
+	for(std::size_t bytes = std::size_t(256) << 10; bytes <= (std::size_t(256) << 20); bytes *= 2) {
+		const buffer src(bytes), dest(bytes);
+		// Enough repeats of the small sizes for the clock to see them
+		const std::size_t inner = std::max<std::size_t>(1, (std::size_t(64) << 20) / bytes);
+
+		const double plain = bench::best_of(reps, [&] {
+			for(std::size_t i = 0; i != inner; ++i) { std::memcpy(dest.data, src.data, bytes); bench::do_not_optimise(dest.data[i % bytes]); }
+		});
+		const double streamed = bench::best_of(reps, [&] {
+			for(std::size_t i = 0; i != inner; ++i) { kane::stream_copy(dest.data, src.data, bytes); bench::do_not_optimise(dest.data[i % bytes]); }
+		});
+
+		const double gigabytes = double(bytes) * double(inner) * 1e-9;
+		std::printf("%8zu KB%s %14.2f %17.2f\n", bytes >> 10, (bytes >= KANELIB_STREAMING_THRESHOLD) ? " *" : "  ",
+			gigabytes / plain, gigabytes / streamed);
+	}
+	std::printf("(* at or above KANELIB_STREAMING_THRESHOLD = %zu KB)\n\n", std::size_t(KANELIB_STREAMING_THRESHOLD) >> 10);
+}
+
+///////////////////////////////////////
+// growth
+///////////////////////////////////////
+// Sums its own buffer over and over until told to stop, counting passes
+class neighbour {
+public:
+	neighbour() : m_buffer(std::size_t(1) << 20), m_stop(false), m_passes(0), m_thread([this] { work(); }) { }
+	~neighbour() {
+		m_stop.store(true, std::memory_order_relaxed);
+		m_thread.join();
+	}
+
+	std::uint64_t passes() const { return m_passes.load(std::memory_order_relaxed); }
+
+private:
+	void work() {
+		const std::uint64_t* const words = reinterpret_cast<const std::uint64_t*>(m_buffer.data);
+		const std::size_t count = m_buffer.size / sizeof(std::uint64_t);
+		while(!m_stop.load(std::memory_order_relaxed)) {
+			std::uint64_t total = 0;
+			for(std::size_t i = 0; i != count; ++i) { total += words[i]; }
+			bench::do_not_optimise(total);
+			m_passes.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	buffer m_buffer;
+	std::atomic<bool> m_stop;
+	std::atomic<std::uint64_t> m_passes;
+	std::thread m_thread;
+};
+
+enum class strategy { memcpy_only, threshold, stream_only };
+
+// Grow from 64KB to limit bytes by doubling, copying the old contents into each new block
+double grow(const std::size_t limit, const strategy how) {
+	const bench::time_point start = bench::now();
+	std::size_t size = std::size_t(64) << 10;
+	unsigned char* data = static_cast<unsigned char*>(std::malloc(size));
+	std::memset(data, 1, size);
+	while(size < limit) {
+		const std::size_t newSize = size * 2;
+		unsigned char* const newData = static_cast<unsigned char*>(std::malloc(newSize));
+		if(!newData) { std::fprintf(stderr, "Out of memory\n"); std::exit(1); }
+
+		const bool stream = (how == strategy::stream_only) || (how == strategy::threshold && size >= KANELIB_STREAMING_THRESHOLD);
+		if(stream) {
+			kane::stream_copy(newData, data, size);
+		} else {
+			std::memcpy(newData, data, size);
+		}
+		// The new half gets written too, as a growing vector's would
+		std::memset(newData + size, 1, newSize - size);
+
+		std::free(data);
+		data = newData;
+		size = newSize;
+	}
+	bench::do_not_optimise(data[size - 1]);
+	std::free(data);
+	return bench::seconds_since(start);
+}
+
+void growth_table(const std::size_t limit) {
+	// How fast the neighbour goes with the machine to itself
+	double idleRate;
+	{
+		neighbour n;
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		const std::uint64_t before = n.passes();
+		const bench::time_point start = bench::now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		idleRate = double(n.passes() - before) / bench::seconds_since(start);
+	}
+
+	std::printf("growth to %zu MB      seconds  neighbour passes/s  (alone: %.0f)\n", limit >> 20, idleRate);
+	const struct { strategy how; const char* name; } strategies[] = {
+		{ strategy::memcpy_only, "memcpy" },
+		{ strategy::threshold, "stream >= threshold" },
+		{ strategy::stream_only, "stream_copy" },
+	};
+	for(const auto& s : strategies) {
+		double best = 0, rate = 0;
+		for(int r = 0; r < reps; ++r) {
+			neighbour n;
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			const std::uint64_t before = n.passes();
+			const double seconds = grow(limit, s.how);
+			const double thisRate = double(n.passes() - before) / seconds;
+			if(r == 0 || seconds < best) { best = seconds; rate = thisRate; }
+		}
+		std::printf("%-22s %8.3f %19.0f  (%.0f%%)\n", s.name, best, rate, 100.0 * rate / idleRate);
+	}
+}
+
+}
+
+int main(int argc, char** argv) {
+	const std::size_t limit = bench::size_argument(argc, argv, 1024) << 20;
+
+	std::printf("KANELIB_STREAMING_THRESHOLD = %zu KB, KANELIB_PREFETCH_DISTANCE = %d bytes, %u hardware threads\n\n",
+		std::size_t(KANELIB_STREAMING_THRESHOLD) >> 10, int(KANELIB_PREFETCH_DISTANCE), std::thread::hardware_concurrency());
+	copy_table();
+	growth_table(limit);
+	return 0;
+}
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// kane::task_scheduler vs a static partition
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A loop over elements whose cost varies, run serially and then four ways with the same number of
+// threads:
+//
+//  - static: kane::thread_pool running one contiguous block per thread, which is what splitting
+//    the range up front amounts to
+//  - pool/64: kane::thread_pool handing out chunks of 64 elements from its shared counter
+//  - stealing: kane::task_scheduler with a grain of 1, so it splits only as threads run dry
+//  - stealing/64: kane::task_scheduler with a grain of 64
+//
+// The per-element costs are uniform (where a static partition is as good as it gets, and the
+// question is what the others cost on top), a ramp from nothing to twice the mean (the last of a
+// static partition's blocks holds nearly twice its fair share), and sparse spikes (1% of the
+// elements, at random, doing 50 times the mean).  Every distribution does about the same total
+// work.
+//
+//   TaskScheduler [elements] [worker threads]		(default 100000, one fewer than the hardware)
+#include "Bench.h"
+
+#include <KaneLib/Threading/TaskScheduler.h>
+#include <KaneLib/Threading/ThreadPool.h>
+
+#include <vector>
+
+namespace {
+
+constexpr int reps = 5;
+constexpr unsigned meanCost = 2000;
+
+// cost steps of an LCG, which the compiler can't shortcut
+inline std::uint64_t work(std::uint64_t x, const unsigned cost) noexcept {
+	for(unsigned k = 0; k != cost; ++k) { x = x * 6364136223846793005ull + 1442695040888963407ull; }
+	return x;
+}
+
+std::vector<unsigned> uniform_costs(const std::size_t count) {
+	return std::vector<unsigned>(count, meanCost);
+}
+
+std::vector<unsigned> ramp_costs(const std::size_t count) {
+	std::vector<unsigned> costs(count);
+	for(std::size_t i = 0; i != count; ++i) { costs[i] = unsigned(2.0 * meanCost * double(i) / double(count)); }
+	return costs;
+}
+
+std::vector<unsigned> spike_costs(const std::size_t count) {
+	// 1% at 50x the mean is half the work; the other 99% share the other half
+	std::vector<unsigned> costs(count, unsigned(meanCost * 0.5 / 0.99));
+	bench::random rng;
+	for(std::size_t i = 0; i != count / 100; ++i) { costs[rng.below(count)] = 50 * meanCost; }
+	return costs;
+}
+
+void run(const char* const name, const std::vector<unsigned>& costs, kane::thread_pool& pool, kane::task_scheduler& scheduler) {
+	const std::size_t count = costs.size();
+	std::vector<std::uint64_t> out(count);
+	const auto element = [&](const std::size_t i) { out[i] = work(i, costs[i]); };
+	const auto checksum = [&] {
+		std::uint64_t total = 0;
+		for(const std::uint64_t x : out) { total += x; }
+		return total;
+	};
+
+	const double serial = bench::best_of(reps, [&] { for(std::size_t i = 0; i != count; ++i) { element(i); } });
+	const std::uint64_t expected = checksum();
+
+	const std::size_t threads = pool.size() + 1;
+	double times[4];
+	times[0] = bench::best_of(reps, [&] {
+		pool.run(threads, [&](const std::size_t t) {
+			const std::size_t end = count * (t + 1) / threads;
+			for(std::size_t i = count * t / threads; i != end; ++i) { element(i); }
+		});
+	});
+	times[1] = bench::best_of(reps, [&] {
+		pool.run((count + 63) / 64, [&](const std::size_t c) {
+			const std::size_t end = std::min(count, (c + 1) * 64);
+			for(std::size_t i = c * 64; i != end; ++i) { element(i); }
+		});
+	});
+	const std::size_t grains[] = { 1, 64 };
+	for(int g = 0; g != 2; ++g) {
+		times[2 + g] = bench::best_of(reps, [&] {
+			scheduler.run(count, grains[g], [&](unsigned, const std::size_t begin, const std::size_t end) {
+				for(std::size_t i = begin; i != end; ++i) { element(i); }
+			});
+		});
+	}
+	if(checksum() != expected) { std::fprintf(stderr, "%s: results differ from the serial run\n", name); std::exit(1); }
+
+	std::printf("%-8s %9.1f", name, serial * 1e3);
+	for(const double t : times) { std::printf(" %9.1f (%4.2fx)", t * 1e3, serial / t); }
+	std::printf("\n");
+}
+
+}
+
+int main(int argc, char** argv) {
+	const std::size_t count = bench::size_argument(argc, argv, 100000);
+	const unsigned workers = (argc > 2) ? unsigned(std::strtoul(argv[2], NULL, 10)) : kane::thread_pool::default_thread_count();
+
+	kane::thread_pool pool(workers);
+	kane::task_scheduler scheduler(workers);
+
+	std::printf("%zu elements, %u threads; milliseconds (speedup over serial)\n\n", count, scheduler.concurrency());
+	std::printf("%-8s %9s %17s %17s %17s %17s\n", "", "serial", "static", "pool/64", "stealing", "stealing/64");
+	run("uniform", uniform_costs(count), pool, scheduler);
+	run("ramp", ramp_costs(count), pool, scheduler);
+	run("spikes", spike_costs(count), pool, scheduler);
+	return 0;
+}